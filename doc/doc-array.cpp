@@ -10,10 +10,7 @@ int main(void)
 	std::cout << "Intepreting json: '" << strJSON << "'" << std::endl;
 	Json::Value j = Json::deserialize(strJSON);
 
-	Json::Array arr = j.asArray();
-
-	for (int i = 0; i < 6; ++i) {
-		Json::Value v = arr[i];
+	for (const Json::Value& v : j) {
 		switch (v.getType()) {
 		case Json::JVSTRING:
 			std::cout << v.asString() << std::endl;
@@ -4,6 +4,8 @@
 #include "JsonValue.hpp"
 
 #include <map>
+#include <vector>
+#include <utility>
 
 namespace Json {
 
@@ -59,11 +61,25 @@ namespace Json {
 		 * @return The created Json::Value.
 		 * @see Json::value_t
 		 */
-		static Json::Value create(Json::value_t v) throw (Json::Exception)
+		static Json::Value create(const Json::value_t& v) throw (Json::Exception)
 		{
 			return Json::Value(v);
 		}
 
+		/**
+		 * Creates a single value JSON structure, taking over the
+		 * provided value. Strings, Objects and Arrays are moved into
+		 * the created Json::Value instead of being copied.
+		 *
+		 * @param v The value to build a Json::Value from.
+		 * @return The created Json::Value.
+		 * @see create(const Json::value_t&)
+		 */
+		static Json::Value create(Json::value_t&& v) throw (Json::Exception)
+		{
+			return Json::Value(std::move(v));
+		}
+
 		/**
 		 * Creates a Json::Value which does not differ
 		 * from input parameter 'v' in any way. Kept here to
@@ -72,11 +88,22 @@ namespace Json {
 		 * @param v The Json::Value to create a user from v.
 		 * @return The created Json::Value.
 		 */
-		static Json::Value create(Json::Value v)
+		static Json::Value create(const Json::Value& v)
 		{
 			return v;
 		}
 
+		/**
+		 * Moves 'v' into the returned Json::Value.
+		 *
+		 * @param v The Json::Value to take over.
+		 * @return The created Json::Value.
+		 */
+		static Json::Value create(Json::Value&& v)
+		{
+			return std::move(v);
+		}
+
 		/**
 		 * Creates a NULL valued JSON structure.
 		 * To create a JSON structure from any other type,
@@ -109,15 +136,36 @@ namespace Json {
 		 * @param v The map which should be interpreted as Json::Value
 		 */
 		template <class T>
-		static Json::Value create(std::map<std::string, T> v) throw (Json::Exception) {
+		static Json::Value create(const std::map<std::string, T>& v) throw (Json::Exception) {
 			Json::Object target;
 
 			typename std::map<std::string, T>::const_iterator it;
 			for (it = v.begin(); it != v.end(); it++) {
-				target[it->first] = Json::Value(Json::Builder::create(it->second));
+				target.emplace_hint(target.end(), it->first, Json::Builder::create(it->second));
+			}
+
+			return Json::Value(std::move(target));
+		}
+
+		/**
+		 * Creates a JSON Object from an expiring std::map.
+		 *
+		 * Same as create(const std::map<std::string, T>&), but every
+		 * value is moved into the created Json::Object instead of copied.
+		 *
+		 * @tparam T The value of the Object.
+		 * @param v The map which should be interpreted as Json::Value
+		 */
+		template <class T>
+		static Json::Value create(std::map<std::string, T>&& v) throw (Json::Exception) {
+			Json::Object target;
+
+			typename std::map<std::string, T>::iterator it;
+			for (it = v.begin(); it != v.end(); it++) {
+				target.emplace_hint(target.end(), it->first, Json::Builder::create(std::move(it->second)));
 			}
 
-			return Json::Value(target);
+			return Json::Value(std::move(target));
 		}
 
 		/**
@@ -139,15 +187,102 @@ namespace Json {
 		 * @param v The vector which should be interpreted as Json::Value
 		 */
 		template <class T>
-		static Json::Value create(std::vector<T> v) throw (Json::Exception) {
+		static Json::Value create(const std::vector<T>& v) throw (Json::Exception) {
 			Json::Array target;
+			target.reserve(v.size());
 
 			typename std::vector<T>::const_iterator it;
 			for(it = v.begin(); it != v.end(); it++) {
-				target.push_back(Json::Builder::create(*it));
+				target.emplace_back(Json::Builder::create(*it));
+			}
+
+			return Json::Value(std::move(target));
+		}
+
+		/**
+		 * Creates a JSON Array from a std::vector of doubles.
+		 * The Array is packed; see Json::Value::asDoubleSpan().
+		 *
+		 * @param v The vector which should be interpreted as Json::Value
+		 */
+		static Json::Value create(const std::vector<double>& v) throw (Json::Exception)
+		{
+			return Json::Value(std::vector<double>(v));
+		}
+
+		/**
+		 * Creates a packed JSON Array by taking over a std::vector of doubles.
+		 *
+		 * @param v The vector which should be interpreted as Json::Value
+		 */
+		static Json::Value create(std::vector<double>&& v) throw (Json::Exception)
+		{
+			return Json::Value(std::move(v));
+		}
+
+		/**
+		 * Creates a JSON Array from a std::vector of integers.
+		 * The Array is packed; see Json::Value::asIntSpan().
+		 *
+		 * @param v The vector which should be interpreted as Json::Value
+		 */
+		static Json::Value create(const std::vector<Json::Int>& v) throw (Json::Exception)
+		{
+			return Json::Value(std::vector<int64_t>(v.begin(), v.end()));
+		}
+
+		/**
+		 * Same as create(const std::vector<Json::Int>&), for an expiring
+		 * vector, which would otherwise be taken by create(std::vector<T>&&).
+		 *
+		 * @param v The vector which should be interpreted as Json::Value
+		 */
+		static Json::Value create(std::vector<Json::Int>&& v) throw (Json::Exception)
+		{
+			return Json::Value(std::vector<int64_t>(v.begin(), v.end()));
+		}
+
+		/**
+		 * Creates a JSON Array from a std::vector of 64-bit integers.
+		 * The Array is packed; see Json::Value::asIntSpan().
+		 *
+		 * @param v The vector which should be interpreted as Json::Value
+		 */
+		static Json::Value create(const std::vector<int64_t>& v) throw (Json::Exception)
+		{
+			return Json::Value(std::vector<int64_t>(v));
+		}
+
+		/**
+		 * Creates a packed JSON Array by taking over a std::vector of 64-bit integers.
+		 *
+		 * @param v The vector which should be interpreted as Json::Value
+		 */
+		static Json::Value create(std::vector<int64_t>&& v) throw (Json::Exception)
+		{
+			return Json::Value(std::move(v));
+		}
+
+		/**
+		 * Creates a JSON Array from an expiring std::vector.
+		 *
+		 * Same as create(const std::vector<T>&), but every
+		 * member is moved into the created Json::Array instead of copied.
+		 *
+		 * @tparam T The value of the Array.
+		 * @param v The vector which should be interpreted as Json::Value
+		 */
+		template <class T>
+		static Json::Value create(std::vector<T>&& v) throw (Json::Exception) {
+			Json::Array target;
+			target.reserve(v.size());
+
+			typename std::vector<T>::iterator it;
+			for(it = v.begin(); it != v.end(); it++) {
+				target.emplace_back(Json::Builder::create(std::move(*it)));
 			}
 
-			return Json::Value(target);
+			return Json::Value(std::move(target));
 		}
 	};
 
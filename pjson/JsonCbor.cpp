@@ -0,0 +1,556 @@
+#include "JsonCbor.hpp"
+#include "JsonBuilder.hpp"
+#include "JsonReader.hpp"
+#include "JsonTreeBuilder.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+	/** The major types of RFC 8949, in the top three bits of an item's first byte. */
+	enum Major {
+		MAJOR_UNSIGNED,
+		MAJOR_NEGATIVE,
+		MAJOR_BYTES,
+		MAJOR_TEXT,
+		MAJOR_ARRAY,
+		MAJOR_MAP,
+		MAJOR_TAG,
+		MAJOR_SIMPLE
+	};
+
+	/** The additional information of an item whose length is indefinite. */
+	const unsigned char INDEFINITE = 31;
+
+	/** The items of major type 7 which are used. */
+	const unsigned char CBOR_FALSE  = 0xf4;
+	const unsigned char CBOR_TRUE   = 0xf5;
+	const unsigned char CBOR_NULL   = 0xf6;
+	const unsigned char CBOR_HALF   = 0xf9;
+	const unsigned char CBOR_SINGLE = 0xfa;
+	const unsigned char CBOR_DOUBLE = 0xfb;
+	const unsigned char CBOR_BREAK  = 0xff;
+
+	void
+	bigEndian(std::string& out, Json::UInt64 n, size_t bytes)
+	{
+		for (size_t shift = 8 * bytes; shift > 0; shift -= 8) {
+			out += static_cast<char>(n >> (shift - 8));
+		}
+	}
+
+	/*
+	 * Writes the head of an item: its major type and its argument, in
+	 * as few bytes as it fits in.
+	 */
+	void
+	head(std::string& out, Major major, Json::UInt64 argument)
+	{
+		unsigned char initial = major << 5;
+		if (argument < 24) {
+			out += static_cast<char>(initial | argument);
+		} else if (argument <= 0xff) {
+			out += static_cast<char>(initial | 24);
+			bigEndian(out, argument, 1);
+		} else if (argument <= 0xffff) {
+			out += static_cast<char>(initial | 25);
+			bigEndian(out, argument, 2);
+		} else if (argument <= 0xffffffff) {
+			out += static_cast<char>(initial | 26);
+			bigEndian(out, argument, 4);
+		} else {
+			out += static_cast<char>(initial | 27);
+			bigEndian(out, argument, 8);
+		}
+	}
+
+	void
+	integer(std::string& out, Json::Int64 i)
+	{
+		if (i >= 0) {
+			head(out, MAJOR_UNSIGNED, static_cast<Json::UInt64>(i));
+		} else {
+			/* Negative integers are written as -1 - i. */
+			head(out, MAJOR_NEGATIVE, ~static_cast<Json::UInt64>(i));
+		}
+	}
+
+	void
+	text(std::string& out, Json::StringView str)
+	{
+		head(out, MAJOR_TEXT, str.length());
+		out.append(str.data(), str.length());
+	}
+
+	/*
+	 * Tells whether 'd' is exactly a half precision float, and which.
+	 */
+	bool
+	half(double d, uint16_t& h)
+	{
+		if (std::isnan(d)) {
+			h = 0x7e00;
+			return true;
+		}
+
+		uint16_t sign = std::signbit(d) ? 0x8000 : 0;
+		if (std::isinf(d) || 0 == d) {
+			h = sign | (std::isinf(d) ? 0x7c00 : 0);
+			return true;
+		}
+
+		/* |d| = m * 2^exponent, where 0.5 <= m < 1. */
+		int exponent;
+		double m = std::frexp(std::fabs(d), &exponent);
+
+		if (exponent >= -13 && exponent <= 16) {
+			/* Normal; 11 significant bits, the first of which is implied. */
+			double significand = std::ldexp(m, 11);
+			if (significand != std::trunc(significand)) return false;
+			h = sign | ((exponent + 14) << 10) | (static_cast<uint16_t>(significand) - 0x400);
+			return true;
+		}
+
+		if (exponent >= -23 && exponent < -13) {
+			/* Subnormal; a multiple of 2^-24. */
+			double multiple = std::ldexp(std::fabs(d), 24);
+			if (multiple != std::trunc(multiple)) return false;
+			h = sign | static_cast<uint16_t>(multiple);
+			return true;
+		}
+
+		return false;
+	}
+
+	double
+	halfToDouble(uint16_t h)
+	{
+		int exponent = (h >> 10) & 0x1f;
+		int mantissa = h & 0x3ff;
+
+		double d;
+		if (0 == exponent) {
+			d = std::ldexp(mantissa, -24);
+		} else if (0x1f == exponent) {
+			d = (0 == mantissa) ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+		} else {
+			d = std::ldexp(mantissa + 0x400, exponent - 25);
+		}
+		return (h & 0x8000) ? -d : d;
+	}
+
+	/*
+	 * Writes 'd' as the shortest float which holds it exactly.
+	 */
+	void
+	real(std::string& out, double d)
+	{
+		uint16_t h;
+		if (half(d, h)) {
+			out += static_cast<char>(CBOR_HALF);
+			bigEndian(out, h, 2);
+			return;
+		}
+
+		if (std::fabs(d) <= std::numeric_limits<float>::max() && static_cast<double>(static_cast<float>(d)) == d) {
+			float f = static_cast<float>(d);
+			uint32_t bits;
+			std::memcpy(&bits, &f, sizeof(f));
+			out += static_cast<char>(CBOR_SINGLE);
+			bigEndian(out, bits, 4);
+			return;
+		}
+
+		uint64_t bits;
+		std::memcpy(&bits, &d, sizeof(d));
+		out += static_cast<char>(CBOR_DOUBLE);
+		bigEndian(out, bits, 8);
+	}
+
+	/*
+	 * Encodes bytes as base64url without padding, which is how
+	 * RFC 8949 section 6.1 converts byte strings to JSON.
+	 */
+	std::string
+	base64url(Json::StringView bytes)
+	{
+		static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+		const unsigned char *b = reinterpret_cast<const unsigned char*>(bytes.data());
+		size_t length = bytes.length();
+
+		std::string out;
+		out.reserve((length * 4 + 2) / 3);
+		for (size_t i = 0; i < length; i += 3) {
+			uint32_t n = b[i] << 16;
+			if (i + 1 < length) n |= b[i + 1] << 8;
+			if (i + 2 < length) n |= b[i + 2];
+
+			out += alphabet[(n >> 18) & 0x3f];
+			out += alphabet[(n >> 12) & 0x3f];
+			if (i + 1 < length) out += alphabet[(n >> 6) & 0x3f];
+			if (i + 2 < length) out += alphabet[n & 0x3f];
+		}
+		return out;
+	}
+
+	/*
+	 * Reads one CBOR item into a Json::Value, see Json::fromCBOR.
+	 */
+	class Decoder
+	{
+		public:
+			Decoder(Json::StringView bytes) :
+				pos(reinterpret_cast<const unsigned char*>(bytes.data())),
+				end(reinterpret_cast<const unsigned char*>(bytes.data()) + bytes.length())
+			{
+			}
+
+			Json::Value item() throw (Json::Exception);
+
+		private:
+			/** An Array or map which is being read. */
+			struct Open
+			{
+				/** How many more members, or pairs, it has, unless its length is indefinite. */
+				Json::UInt64 remaining;
+				bool         indefinite;
+				bool         object;
+				/** Whether a key of the map is next. */
+				bool         key;
+			};
+
+			const unsigned char *pos, *end;
+
+			/** The joined chunks of the last string of indefinite length, or the last byte string. */
+			std::string buffer;
+
+			unsigned char byte() throw (Json::Exception);
+			Json::UInt64 bigEndian(size_t bytes) throw (Json::Exception);
+			unsigned char initial() throw (Json::Exception);
+			Json::UInt64 argument(unsigned char initial, bool& indefinite) throw (Json::Exception);
+			void fits(Json::UInt64 count, size_t size) throw (Json::Exception);
+			Json::StringView string(unsigned char initial) throw (Json::Exception);
+			Json::Value simple(unsigned char initial) throw (Json::Exception);
+	};
+
+	unsigned char
+	Decoder::byte() throw (Json::Exception)
+	{
+		if (this->pos == this->end) throw Json::Exception("Unexpected end of CBOR input.");
+		return *this->pos++;
+	}
+
+	Json::UInt64
+	Decoder::bigEndian(size_t bytes) throw (Json::Exception)
+	{
+		this->fits(bytes, 1);
+
+		Json::UInt64 n = 0;
+		for (size_t i = 0; i < bytes; ++i) n = (n << 8) | *this->pos++;
+		return n;
+	}
+
+	/*
+	 * The first byte of the next item, after any tags; they are dropped.
+	 */
+	unsigned char
+	Decoder::initial() throw (Json::Exception)
+	{
+		unsigned char initial = this->byte();
+		while (MAJOR_TAG == initial >> 5) {
+			bool indefinite;
+			this->argument(initial, indefinite);
+			if (indefinite) throw Json::Exception("Invalid CBOR tag.");
+			initial = this->byte();
+		}
+		return initial;
+	}
+
+	Json::UInt64
+	Decoder::argument(unsigned char initial, bool& indefinite) throw (Json::Exception)
+	{
+		unsigned char info = initial & 0x1f;
+
+		indefinite = (INDEFINITE == info);
+		if (info < 24) return info;
+		if (info <= 27) return this->bigEndian(static_cast<size_t>(1) << (info - 24));
+		if (indefinite) return 0;
+		throw Json::Exception("Invalid CBOR additional information.");
+	}
+
+	/*
+	 * Makes sure 'count' items of at least 'size' bytes each are left,
+	 * so that a length is not trusted with more than the input holds.
+	 */
+	void
+	Decoder::fits(Json::UInt64 count, size_t size) throw (Json::Exception)
+	{
+		if (count > static_cast<Json::UInt64>(this->end - this->pos) / size) {
+			throw Json::Exception("Unexpected end of CBOR input.");
+		}
+	}
+
+	/*
+	 * Reads a text or byte string, the latter converted to base64url.
+	 * The view is valid until the next string is read.
+	 */
+	Json::StringView
+	Decoder::string(unsigned char initial) throw (Json::Exception)
+	{
+		bool indefinite;
+		Json::UInt64 length = this->argument(initial, indefinite);
+
+		Json::StringView str;
+		if (!indefinite) {
+			this->fits(length, 1);
+			str = Json::StringView(reinterpret_cast<const char*>(this->pos), length);
+			this->pos += length;
+		} else {
+			this->buffer.clear();
+			for (unsigned char chunk = this->byte(); CBOR_BREAK != chunk; chunk = this->byte()) {
+				if ((chunk >> 5) != (initial >> 5) || INDEFINITE == (chunk & 0x1f)) {
+					throw Json::Exception("Invalid chunk in CBOR string.");
+				}
+				length = this->argument(chunk, indefinite);
+				this->fits(length, 1);
+				this->buffer.append(reinterpret_cast<const char*>(this->pos), length);
+				this->pos += length;
+			}
+			str = this->buffer;
+		}
+
+		if (MAJOR_BYTES == initial >> 5) {
+			this->buffer = base64url(str);
+			str = this->buffer;
+		}
+		return str;
+	}
+
+	Json::Value
+	Decoder::simple(unsigned char initial) throw (Json::Exception)
+	{
+		switch (initial) {
+			case CBOR_FALSE:
+				return Json::Builder::create(false);
+
+			case CBOR_TRUE:
+				return Json::Builder::create(true);
+
+			case CBOR_NULL:
+			case CBOR_NULL + 1: /* undefined */
+				return Json::Builder::create();
+
+			case CBOR_HALF:
+				return Json::Builder::create(halfToDouble(static_cast<uint16_t>(this->bigEndian(2))));
+
+			case CBOR_SINGLE: {
+				uint32_t bits = static_cast<uint32_t>(this->bigEndian(4));
+				float f;
+				std::memcpy(&f, &bits, sizeof(f));
+				return Json::Builder::create(static_cast<double>(f));
+			}
+
+			case CBOR_DOUBLE: {
+				uint64_t bits = this->bigEndian(8);
+				double d;
+				std::memcpy(&d, &bits, sizeof(d));
+				return Json::Builder::create(d);
+			}
+
+			case CBOR_BREAK:
+				throw Json::Exception("Unexpected CBOR break.");
+
+			default:
+				throw Json::Exception("Unsupported CBOR simple value.");
+		}
+	}
+
+	Json::Value
+	Decoder::item() throw (Json::Exception)
+	{
+		Json::TreeBuilder builder;
+		std::vector<Open> open;
+
+		do {
+			bool closed = false;
+
+			if (!open.empty()) {
+				Open& top = open.back();
+
+				if (top.indefinite ? (this->pos != this->end && CBOR_BREAK == *this->pos) : (0 == top.remaining)) {
+					if (top.indefinite) {
+						if (top.object && !top.key) throw Json::Exception("CBOR map is missing a value.");
+						this->pos++;
+					}
+					open.pop_back();
+					builder.end();
+					closed = true;
+				} else if (top.object && top.key) {
+					unsigned char initial = this->initial();
+					if (MAJOR_TEXT != initial >> 5) throw Json::Exception("CBOR map key is not a text string.");
+					builder.key(this->string(initial));
+					top.key = false;
+					continue;
+				}
+			}
+
+			if (!closed) {
+				unsigned char initial = this->initial();
+				bool indefinite;
+
+				switch (initial >> 5) {
+					case MAJOR_UNSIGNED:
+					case MAJOR_NEGATIVE: {
+						Json::UInt64 n = this->argument(initial, indefinite);
+						if (indefinite) throw Json::Exception("Invalid CBOR integer.");
+						if (MAJOR_UNSIGNED == initial >> 5) {
+							builder.value(Json::Builder::create(n));
+						} else if (n <= static_cast<Json::UInt64>(std::numeric_limits<Json::Int64>::max())) {
+							builder.value(Json::Builder::create(-1 - static_cast<Json::Int64>(n)));
+						} else {
+							builder.value(Json::Builder::create(-1.0 - static_cast<double>(n)));
+						}
+						break;
+					}
+
+					case MAJOR_BYTES:
+					case MAJOR_TEXT: {
+						Json::StringView str = this->string(initial);
+						builder.value(Json::Builder::create(std::string(str.data(), str.length())));
+						break;
+					}
+
+					case MAJOR_ARRAY:
+					case MAJOR_MAP: {
+						bool object = (MAJOR_MAP == initial >> 5);
+						Json::UInt64 n = this->argument(initial, indefinite);
+						if (!indefinite) this->fits(n, object ? 2 : 1);
+
+						Open o = { n, indefinite, object, object };
+						open.push_back(o);
+						if (object) {
+							builder.beginObject();
+						} else {
+							builder.beginArray(n);
+						}
+						continue;
+					}
+
+					default:
+						builder.value(this->simple(initial));
+						break;
+				}
+			}
+
+			/* An item is complete; it is a member of the enclosing Array or map, if any. */
+			if (!open.empty()) {
+				Open& top = open.back();
+				if (!top.indefinite) top.remaining--;
+				top.key = top.object;
+			}
+		} while (!open.empty());
+
+		if (this->pos != this->end) throw Json::Exception("Unexpected data after the CBOR item.");
+		return std::move(builder.result());
+	}
+}
+
+namespace Json {
+
+	/**
+	 * Writes Json::Values as CBOR, see Json::toCBOR.
+	 */
+	class CborWriter
+	{
+		public:
+			static void write(std::string& out, const Json::Value& v)
+			{
+				switch (v.type) {
+					case JVOBJECT: {
+						const Json::Object& obj = v.asObject();
+						head(out, MAJOR_MAP, obj.size());
+						for (Json::Object::const_iterator it = obj.begin(); it != obj.end(); ++it) {
+							text(out, it->first);
+							write(out, it->second);
+						}
+						break;
+					}
+
+					case JVARRAY:  writeArray(out, v); break;
+					case JVNUMBER: writeNumber(out, v); break;
+					case JVSTRING: text(out, v.asStringView()); break;
+					case JVBOOL:   out += static_cast<char>(v.asBool() ? CBOR_TRUE : CBOR_FALSE); break;
+					case JVRAW:    writeRaw(out, v); break;
+					default:       out += static_cast<char>(CBOR_NULL); break;
+				}
+			}
+
+		private:
+			static void writeNumber(std::string& out, const Json::Value& v)
+			{
+				if (const Json::Int *i = boost::get<Json::Int>(&v.value)) {
+					integer(out, *i);
+				} else if (const Json::Int64 *i64 = boost::get<Json::Int64>(&v.value)) {
+					integer(out, *i64);
+				} else if (const Json::UInt64 *u64 = boost::get<Json::UInt64>(&v.value)) {
+					head(out, MAJOR_UNSIGNED, *u64);
+				} else {
+					real(out, boost::get<Json::Number>(v.value));
+				}
+			}
+
+			static void writeArray(std::string& out, const Json::Value& v)
+			{
+				typedef Json::Shared<Json::PackedArray<double> >  Doubles;
+				typedef Json::Shared<Json::PackedArray<int64_t> > Ints;
+
+				/* Packed Arrays are written as they are, without expanding them. */
+				if (const Doubles *d = boost::get<Doubles>(&v.value)) {
+					const std::vector<double>& values = d->get().values;
+					head(out, MAJOR_ARRAY, values.size());
+					for (size_t i = 0; i < values.size(); ++i) real(out, values[i]);
+				} else if (const Ints *i = boost::get<Ints>(&v.value)) {
+					const std::vector<int64_t>& values = i->get().values;
+					head(out, MAJOR_ARRAY, values.size());
+					for (size_t j = 0; j < values.size(); ++j) integer(out, values[j]);
+				} else {
+					const Json::Array& arr = v.asArray();
+					head(out, MAJOR_ARRAY, arr.size());
+					for (Json::Array::const_iterator it = arr.begin(); it != arr.end(); ++it) write(out, *it);
+				}
+			}
+
+			static void writeRaw(std::string& out, const Json::Value& v)
+			{
+				Json::Reader r(v.asRawJson().json());
+				Json::Value tree = r.tree();
+				r.next();
+				write(out, tree);
+			}
+	};
+}
+
+void
+Json::toCBOR(const Json::Value& value, std::string& out) throw (Json::Exception)
+{
+	Json::CborWriter::write(out, value);
+}
+
+std::string
+Json::toCBOR(const Json::Value& value) throw (Json::Exception)
+{
+	std::string out;
+	Json::toCBOR(value, out);
+	return out;
+}
+
+Json::Value
+Json::fromCBOR(Json::StringView bytes) throw (Json::Exception)
+{
+	Decoder decoder(bytes);
+	return decoder.item();
+}
@@ -0,0 +1,61 @@
+#ifndef __JSONCBOR_HPP__
+#define __JSONCBOR_HPP__
+
+#include "JsonValue.hpp"
+#include "JsonException.hpp"
+
+#include <string>
+
+namespace Json {
+
+	/**
+	 * Encodes 'value' as CBOR (RFC 8949), appending it to 'out'.
+	 *
+	 * Integers are written as CBOR integers and other numbers as the
+	 * shortest float which holds them exactly, so the value decodes
+	 * into the same numbers. Strings are written as they are, with
+	 * their length, without being escaped. Every Object and Array is
+	 * written with its length, so a decoder can size it up front.
+	 * Json::RawJson fragments are parsed and written as what they hold.
+	 *
+	 * @param value The value to encode.
+	 * @param out   The string to append the encoded bytes to.
+	 */
+	void
+	toCBOR(const Json::Value& value, std::string& out) throw (Json::Exception);
+
+	/**
+	 * Encodes 'value' as CBOR (RFC 8949):
+	 * @code
+	 * std::string body = Json::toCBOR(response);
+	 * @endcode
+	 *
+	 * @param value The value to encode.
+	 * @returns The encoded bytes.
+	 * @see toCBOR(const Json::Value&, std::string&)
+	 */
+	std::string
+	toCBOR(const Json::Value& value) throw (Json::Exception);
+
+	/**
+	 * Decodes one CBOR (RFC 8949) data item into a Json::Value. Arrays
+	 * and strings are allocated at the size the encoding gives them,
+	 * and numbers are taken as they are, without any text conversion.
+	 *
+	 * Items which have no JSON equivalent are converted as RFC 8949
+	 * section 6.1 suggests: byte strings become base64url strings,
+	 * undefined becomes null, and tags are dropped in favor of what
+	 * they enclose. Strings of indefinite length are joined.
+	 *
+	 * @param bytes The encoded item.
+	 * @throws Json::Exception If 'bytes' is not exactly one well-formed
+	 *                         item, or has a map key which is not a text
+	 *                         string or a simple value which is neither
+	 *                         a boolean, null nor undefined.
+	 * @returns The decoded value.
+	 */
+	Json::Value
+	fromCBOR(Json::StringView bytes) throw (Json::Exception);
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include "JsonColumns.hpp"
+
+static void
+setType(Json::Column& col, Json::Column::ColumnType type, size_t row, size_t rows) throw (Json::Exception)
+{
+	if (col.type == type) return;
+
+	if (Json::Column::COLUMN_NULL == col.type) {
+		/* Rows before the first value were all null. */
+		col.type = type;
+		switch (type) {
+			case Json::Column::COLUMN_INT:
+				col.ints.reserve(rows);
+				col.ints.resize(row);
+				break;
+			case Json::Column::COLUMN_DOUBLE:
+				col.doubles.reserve(rows);
+				col.doubles.resize(row);
+				break;
+			case Json::Column::COLUMN_BOOL:
+				col.bools.reserve(rows);
+				col.bools.resize(row);
+				break;
+			case Json::Column::COLUMN_STRING:
+				col.offsets.reserve(rows + 1);
+				col.offsets.resize(row + 1);
+				break;
+			default: break;
+		}
+		return;
+	}
+
+	if (Json::Column::COLUMN_INT == col.type && Json::Column::COLUMN_DOUBLE == type) {
+		col.doubles.reserve(rows);
+		col.doubles.assign(col.ints.begin(), col.ints.end());
+		std::vector<int64_t>().swap(col.ints);
+		col.type = type;
+		return;
+	}
+
+	if (Json::Column::COLUMN_DOUBLE == col.type && Json::Column::COLUMN_INT == type) {
+		return;
+	}
+
+	throw Json::Exception("Column holds values of different types.");
+}
+
+static void
+appendNull(Json::Column& col)
+{
+	switch (col.type) {
+		case Json::Column::COLUMN_INT:    col.ints.push_back(0);    break;
+		case Json::Column::COLUMN_DOUBLE: col.doubles.push_back(0); break;
+		case Json::Column::COLUMN_BOOL:   col.bools.push_back(0);   break;
+		case Json::Column::COLUMN_STRING: col.offsets.push_back(col.chars.size()); break;
+		default: break;
+	}
+}
+
+static void
+append(Json::Column& col, const Json::Value& v, size_t row, size_t rows) throw (Json::Exception)
+{
+	switch (v.getType()) {
+		case Json::JVNUMBER:
+			/* Unsigned integers beyond int64_t only fit a double column. */
+			if (v.isInteger() && (v.asNumber() < 0 || v.asUInt64() <= INT64_MAX)) {
+				setType(col, Json::Column::COLUMN_INT, row, rows);
+			} else {
+				setType(col, Json::Column::COLUMN_DOUBLE, row, rows);
+			}
+			if (Json::Column::COLUMN_INT == col.type) {
+				col.ints.push_back(v.asInt64());
+			} else {
+				col.doubles.push_back(v.asNumber());
+			}
+			break;
+
+		case Json::JVBOOL:
+			setType(col, Json::Column::COLUMN_BOOL, row, rows);
+			col.bools.push_back(v.asBool());
+			break;
+
+		case Json::JVSTRING: {
+			setType(col, Json::Column::COLUMN_STRING, row, rows);
+			Json::StringView str = v.asStringView();
+			col.chars.insert(col.chars.end(), str.begin(), str.end());
+			col.offsets.push_back(col.chars.size());
+			break;
+		}
+
+		case Json::JVNULL:
+			appendNull(col);
+			return;
+
+		default:
+			throw Json::Exception("Column values must be numbers, booleans or strings.");
+	}
+
+	col.valid[row / 8] |= (1 << (row % 8));
+}
+
+Json::Columns
+Json::toColumns(const Json::Value& array, const std::vector<std::string>& keys) throw (Json::Exception)
+{
+	const Json::Array& arr = array.asArray();
+
+	Json::Columns result;
+	result.rows = arr.size();
+
+	std::vector<Json::Key> lookup;
+	lookup.reserve(keys.size());
+	result.columns.reserve(keys.size());
+	for (std::vector<std::string>::const_iterator it = keys.begin(); it != keys.end(); ++it) {
+		lookup.push_back(Json::Key(*it));
+		result.columns.push_back(Json::Column(*it));
+		result.columns.back().valid.resize((arr.size() + 7) / 8);
+	}
+
+	for (size_t row = 0; row < arr.size(); ++row) {
+		if (Json::JVOBJECT != arr[row].getType()) {
+			throw Json::Exception("Array member is not an object.");
+		}
+
+		for (size_t c = 0; c < lookup.size(); ++c) {
+			const Json::Value *v = arr[row].find(lookup[c]);
+			if (NULL == v) {
+				appendNull(result.columns[c]);
+			} else {
+				append(result.columns[c], *v, row, result.rows);
+			}
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,147 @@
+#ifndef __JSONCOLUMNS_HPP__
+#define __JSONCOLUMNS_HPP__
+
+#include "JsonValue.hpp"
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace Json {
+
+	/// One column extracted from an Array of Objects.
+	/**
+	 * Holds the values of one key of every Object in an Array, stored
+	 * contiguously in a buffer matching the type of the values. Only
+	 * the buffer matching 'type' is filled, and it holds exactly one
+	 * entry per row; rows which are null hold 0 (or an empty string).
+	 *
+	 * Whether a row is null is recorded in the 'valid' bitmap, where
+	 * bit (row % 8) of byte (row / 8) is set for rows which hold a value.
+	 *
+	 * @see Json::toColumns
+	 */
+	class Column
+	{
+		public:
+			/**
+			 * The type of the values in a column.
+			 */
+			enum ColumnType {
+				/** Every row is null. */
+				COLUMN_NULL,
+				/** Integral numbers, stored in 'ints'. */
+				COLUMN_INT,
+				/** Numbers, stored in 'doubles'. */
+				COLUMN_DOUBLE,
+				/** Booleans, stored in 'bools' as 0 or 1. */
+				COLUMN_BOOL,
+				/** Strings, stored in 'chars' and 'offsets'. */
+				COLUMN_STRING
+			};
+
+			Column(const std::string& name) : name(name), type(COLUMN_NULL) {}
+
+			/** The key this column was extracted from. */
+			std::string name;
+
+			/** The type of the values in this column. */
+			ColumnType type;
+
+			/** Values of a COLUMN_INT column. */
+			std::vector<int64_t> ints;
+
+			/** Values of a COLUMN_DOUBLE column. */
+			std::vector<double> doubles;
+
+			/** Values of a COLUMN_BOOL column. */
+			std::vector<uint8_t> bools;
+
+			/**
+			 * Characters of all strings in a COLUMN_STRING column,
+			 * one after another without separators.
+			 */
+			std::vector<char> chars;
+
+			/**
+			 * Offsets into 'chars' of a COLUMN_STRING column. Row i spans
+			 * [offsets[i], offsets[i + 1]), so there is one more offset than rows.
+			 */
+			std::vector<size_t> offsets;
+
+			/** Validity bitmap; a set bit means the row holds a value. */
+			std::vector<uint8_t> valid;
+
+			/**
+			 * Tells whether the row is null (or was missing the key).
+			 */
+			bool isNull(size_t row) const
+			{
+				return 0 == (this->valid[row / 8] & (1 << (row % 8)));
+			}
+
+			/**
+			 * The string in a row of a COLUMN_STRING column.
+			 */
+			Json::StringView string(size_t row) const
+			{
+				return Json::StringView(this->chars.data() + this->offsets[row],
+				                        this->offsets[row + 1] - this->offsets[row]);
+			}
+	};
+
+	/// Columns extracted from an Array of Objects.
+	/**
+	 * @see Json::toColumns
+	 */
+	class Columns
+	{
+		public:
+			Columns() : rows(0) {}
+
+			/** The number of rows, i.e. the size of the Array. */
+			size_t rows;
+
+			/** The columns, in the order their keys were requested. */
+			std::vector<Json::Column> columns;
+
+			/**
+			 * Fetches the column extracted from 'key'.
+			 *
+			 * @param key The key the column was extracted from.
+			 * @throws Json::Exception If no such column was extracted.
+			 */
+			const Json::Column& operator[](Json::StringView key) const throw (Json::Exception)
+			{
+				std::vector<Json::Column>::const_iterator it;
+				for (it = this->columns.begin(); it != this->columns.end(); ++it) {
+					if (it->name == key) return *it;
+				}
+				throw Json::Exception("Column does not exist.");
+			}
+	};
+
+	/**
+	 * Extracts the members 'keys' of every Object in an Array into
+	 * one contiguous, typed buffer per key. This turns
+	 * @code
+	 * [ { "ts" : 1, "price" : 9.5 }, { "ts" : 2, "price" : 9.75 } ]
+	 * @endcode
+	 * into an integer column 'ts' and a double column 'price'.
+	 *
+	 * A column holding only integers becomes a COLUMN_INT column. If it
+	 * also holds other numbers it becomes a COLUMN_DOUBLE column. Keys
+	 * missing from an Object, and null values, are recorded as null rows.
+	 *
+	 * @param array The Array of Objects to extract from.
+	 * @param keys  The keys to extract, one column each.
+	 * @throws Json::Exception If array is not an Array, a member of it is
+	 *                         not an Object, or a column holds values of
+	 *                         different types (other than integers and numbers).
+	 * @returns The extracted columns.
+	 */
+	Json::Columns
+	toColumns(const Json::Value& array, const std::vector<std::string>& keys) throw (Json::Exception);
+}
+
+#endif
@@ -0,0 +1,375 @@
+#include "JsonValue.hpp"
+#include "JsonReader.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+	/**
+	 * A number, in the one representation which all numbers equal
+	 * to it share: integers, whether stored as such or as a double,
+	 * as INTEGER if they fit in Json::Int64 and as UNSIGNED otherwise.
+	 * Other numbers are REAL.
+	 */
+	struct NumberKey
+	{
+		enum Kind { INTEGER, UNSIGNED, REAL } kind;
+
+		/** The integer, or the bits of the double. */
+		Json::UInt64 bits;
+
+		bool operator==(const NumberKey& k) const { return this->kind == k.kind && this->bits == k.bits; }
+	};
+
+	NumberKey
+	numberKey(Json::Int64 i)
+	{
+		NumberKey k = { NumberKey::INTEGER, static_cast<Json::UInt64>(i) };
+		return k;
+	}
+
+	NumberKey
+	numberKey(Json::UInt64 u)
+	{
+		NumberKey k = { (u >> 63) ? NumberKey::UNSIGNED : NumberKey::INTEGER, u };
+		return k;
+	}
+
+	NumberKey
+	numberKey(double d)
+	{
+		/* 2^63 and 2^64, which are exact as doubles. */
+		const double int64End = 9223372036854775808.0, uint64End = 18446744073709551616.0;
+
+		if (d == std::trunc(d)) {
+			if (-int64End <= d && d < int64End) return numberKey(static_cast<Json::Int64>(d));
+			if (int64End <= d && d < uint64End) return numberKey(static_cast<Json::UInt64>(d));
+		}
+
+		NumberKey k = { NumberKey::REAL, 0 };
+		std::memcpy(&k.bits, &d, sizeof(d));
+		return k;
+	}
+
+	NumberKey
+	numberKey(const Json::Value& v)
+	{
+		if (!v.isInteger()) return numberKey(v.asNumber());
+		if (v.asNumber() < 0) return numberKey(v.asInt64());
+		return numberKey(v.asUInt64());
+	}
+
+	/*
+	 * The hash is built from the round and the final mix of xxHash64,
+	 * which spread every bit of the input over the whole hash.
+	 */
+	const Json::UInt64 PRIME1 = 0x9E3779B185EBCA87ULL;
+	const Json::UInt64 PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+	const Json::UInt64 PRIME3 = 0x165667B19E3779F9ULL;
+
+	/** What is hashed first for each kind of value, so that e.g. "" and [] differ. */
+	enum Tag { TAG_NULL = 1, TAG_FALSE, TAG_TRUE, TAG_INTEGER, TAG_UNSIGNED, TAG_REAL, TAG_STRING, TAG_ARRAY, TAG_OBJECT };
+
+	inline Json::UInt64
+	absorb(Json::UInt64 h, Json::UInt64 input)
+	{
+		h ^= input * PRIME2;
+		h = (h << 31) | (h >> 33);
+		return h * PRIME1;
+	}
+
+	inline Json::UInt64
+	finish(Json::UInt64 h)
+	{
+		h ^= h >> 33;
+		h *= PRIME2;
+		h ^= h >> 29;
+		h *= PRIME3;
+		h ^= h >> 32;
+		return h;
+	}
+
+	/* Reads 8 bytes as a little endian integer, so the hash is the same on every platform. */
+	inline Json::UInt64
+	load(const char *p)
+	{
+		Json::UInt64 word;
+		std::memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		word = __builtin_bswap64(word);
+#endif
+		return word;
+	}
+
+	Json::UInt64
+	hashNumber(const NumberKey& k)
+	{
+		Tag tag = (NumberKey::INTEGER == k.kind) ? TAG_INTEGER : (NumberKey::UNSIGNED == k.kind) ? TAG_UNSIGNED : TAG_REAL;
+		return finish(absorb(absorb(PRIME3, tag), k.bits));
+	}
+
+	Json::UInt64
+	hashString(Json::StringView str)
+	{
+		Json::UInt64 h = absorb(absorb(PRIME3, TAG_STRING), str.length());
+
+		const char *c = str.data(), *end = c + str.length();
+		for (; end - c >= 8; c += 8) h = absorb(h, load(c));
+
+		Json::UInt64 tail = 0;
+		for (size_t shift = 0; c != end; ++c, shift += 8) {
+			tail |= static_cast<Json::UInt64>(static_cast<unsigned char>(*c)) << shift;
+		}
+		return finish(absorb(h, tail));
+	}
+}
+
+namespace Json {
+
+	/**
+	 * Compares and hashes Json::Values, see Json::Value::operator==()
+	 * and Json::Value::hash().
+	 */
+	class Comparison
+	{
+		public:
+			static bool equal(const Json::Value& a, const Json::Value& b)
+			{
+				if (JVRAW == a.type || JVRAW == b.type) return equalRaw(a, b);
+				if (a.type != b.type) return false;
+
+				switch (a.type) {
+					case JVOBJECT: return equalObjects(a, b);
+					case JVARRAY:  return equalArrays(a, b);
+					case JVNUMBER: return numberKey(a) == numberKey(b);
+					case JVSTRING: return a.asStringView() == b.asStringView();
+					case JVBOOL:   return a.asBool() == b.asBool();
+					default:       return true;
+				}
+			}
+
+			static Json::UInt64 hash(const Json::Value& v)
+			{
+				switch (v.type) {
+					case JVOBJECT: return hashObject(v);
+					case JVARRAY:  return hashArray(v);
+					case JVNUMBER: return hashNumber(numberKey(v));
+					case JVSTRING: return hashString(v.asStringView());
+					case JVBOOL:   return finish(absorb(PRIME3, v.asBool() ? TAG_TRUE : TAG_FALSE));
+					case JVRAW:    return hash(parse(v));
+					default:       return finish(absorb(PRIME3, TAG_NULL));
+				}
+			}
+
+		private:
+			/**
+			 * The members of an Array, whether packed or not.
+			 */
+			struct Members
+			{
+				const Json::Array         *values;
+				const std::vector<double>  *doubles;
+				const std::vector<int64_t> *ints;
+
+				Members(const Json::Value& v) : values(NULL), doubles(NULL), ints(NULL)
+				{
+					typedef Json::Shared<Json::PackedArray<double> >  Doubles;
+					typedef Json::Shared<Json::PackedArray<int64_t> > Ints;
+
+					if (const Doubles *d = boost::get<Doubles>(&v.value)) {
+						this->doubles = &d->get().values;
+					} else if (const Ints *i = boost::get<Ints>(&v.value)) {
+						this->ints = &i->get().values;
+					} else {
+						this->values = &boost::get<Json::Shared<Json::Array> >(v.value).get();
+					}
+				}
+
+				size_t size() const
+				{
+					if (NULL != this->doubles) return this->doubles->size();
+					if (NULL != this->ints) return this->ints->size();
+					return this->values->size();
+				}
+
+				/**
+				 * Sets 'key' to member 'i', unless it is not a number.
+				 */
+				bool number(size_t i, NumberKey& key) const
+				{
+					if (NULL != this->doubles) {
+						key = numberKey((*this->doubles)[i]);
+					} else if (NULL != this->ints) {
+						key = numberKey(static_cast<Json::Int64>((*this->ints)[i]));
+					} else if (JVNUMBER == (*this->values)[i].type) {
+						key = numberKey((*this->values)[i]);
+					} else {
+						return false;
+					}
+					return true;
+				}
+			};
+
+			/**
+			 * The Json::Shared holding the Object or Array 'v', if it is a Json::Shared<T>.
+			 */
+			template <class T> static const Json::Shared<T>*
+			shared(const Json::Value& v)
+			{
+				return boost::get<Json::Shared<T> >(&v.value);
+			}
+
+			template <class T> static bool
+			same(const Json::Value& a, const Json::Value& b)
+			{
+				const Json::Shared<T> *x = shared<T>(a), *y = shared<T>(b);
+				return NULL != x && NULL != y && x->same(*y);
+			}
+
+			/**
+			 * The hash kept with the Object or Array 'v', or 0.
+			 */
+			static Json::UInt64 digest(const Json::Value& v)
+			{
+				if (const Json::Shared<Json::Object> *s = shared<Json::Object>(v)) return s->digest();
+				if (const Json::Shared<Json::Array> *s = shared<Json::Array>(v)) return s->digest();
+				if (const Json::Shared<Json::PackedArray<double> > *s = shared<Json::PackedArray<double> >(v)) return s->digest();
+				if (const Json::Shared<Json::PackedArray<int64_t> > *s = shared<Json::PackedArray<int64_t> >(v)) return s->digest();
+				return 0;
+			}
+
+			static void keep(const Json::Value& v, Json::UInt64 h)
+			{
+				if (const Json::Shared<Json::Object> *s = shared<Json::Object>(v)) s->digest(h);
+				if (const Json::Shared<Json::Array> *s = shared<Json::Array>(v)) s->digest(h);
+				if (const Json::Shared<Json::PackedArray<double> > *s = shared<Json::PackedArray<double> >(v)) s->digest(h);
+				if (const Json::Shared<Json::PackedArray<int64_t> > *s = shared<Json::PackedArray<int64_t> >(v)) s->digest(h);
+			}
+
+			/**
+			 * Tells whether the hashes kept with 'a' and 'b' tell them apart.
+			 */
+			static bool differ(const Json::Value& a, const Json::Value& b)
+			{
+				Json::UInt64 x = digest(a), y = digest(b);
+				return 0 != x && 0 != y && x != y;
+			}
+
+			static bool equalObjects(const Json::Value& a, const Json::Value& b)
+			{
+				if (same<Json::Object>(a, b)) return true;
+				if (differ(a, b)) return false;
+
+				const Json::Object& x = a.asObject();
+				const Json::Object& y = b.asObject();
+				if (x.size() != y.size()) return false;
+
+				/* Both are ordered by key. */
+				for (Json::Object::const_iterator i = x.begin(), j = y.begin(); i != x.end(); ++i, ++j) {
+					if (i->first != j->first || !equal(i->second, j->second)) return false;
+				}
+				return true;
+			}
+
+			static bool equalArrays(const Json::Value& a, const Json::Value& b)
+			{
+				if (same<Json::Array>(a, b) ||
+				    same<Json::PackedArray<double> >(a, b) ||
+				    same<Json::PackedArray<int64_t> >(a, b)) {
+					return true;
+				}
+				if (differ(a, b)) return false;
+
+				Members x(a), y(b);
+				if (x.size() != y.size()) return false;
+
+				for (size_t i = 0; i < x.size(); ++i) {
+					if (NULL != x.values && NULL != y.values) {
+						if (!equal((*x.values)[i], (*y.values)[i])) return false;
+						continue;
+					}
+
+					/* One of them is packed, so both members must be the same number. */
+					NumberKey kx, ky;
+					if (!x.number(i, kx) || !y.number(i, ky) || !(kx == ky)) return false;
+				}
+				return true;
+			}
+
+			static Json::Value parse(const Json::Value& v)
+			{
+				Json::Reader r(v.asRawJson().json());
+				Json::Value tree = r.tree();
+				r.next();
+				return tree;
+			}
+
+			static bool equalRaw(const Json::Value& a, const Json::Value& b)
+			{
+				if (a.type == b.type && a.asRawJson().json() == b.asRawJson().json()) return true;
+				return equal(JVRAW == a.type ? parse(a) : a, JVRAW == b.type ? parse(b) : b);
+			}
+
+			static Json::UInt64 hashObject(const Json::Value& v)
+			{
+				Json::UInt64 h = digest(v);
+				if (0 != h) return h;
+
+				const Json::Object& obj = v.asObject();
+				h = absorb(absorb(PRIME3, TAG_OBJECT), obj.size());
+				for (Json::Object::const_iterator it = obj.begin(); it != obj.end(); ++it) {
+					h = absorb(h, hashString(it->first));
+					h = absorb(h, hash(it->second));
+				}
+
+				h = finish(h);
+				keep(v, h);
+				return h;
+			}
+
+			static Json::UInt64 hashArray(const Json::Value& v)
+			{
+				Json::UInt64 h = digest(v);
+				if (0 != h) return h;
+
+				Members members(v);
+				h = absorb(absorb(PRIME3, TAG_ARRAY), members.size());
+				for (size_t i = 0; i < members.size(); ++i) {
+					NumberKey key;
+					if (NULL != members.values) {
+						h = absorb(h, hash((*members.values)[i]));
+					} else if (members.number(i, key)) {
+						h = absorb(h, hashNumber(key));
+					}
+				}
+
+				h = finish(h);
+				keep(v, h);
+				return h;
+			}
+	};
+}
+
+bool
+Json::Value::operator==(const Json::Value& v) const
+{
+	return Json::Comparison::equal(*this, v);
+}
+
+Json::UInt64
+Json::Value::hash() const
+{
+	return Json::Comparison::hash(*this);
+}
+
+void
+Json::Value::strjsonCanonical(std::string& out, Json::Number n)
+{
+	NumberKey key = numberKey(n);
+	switch (key.kind) {
+		case NumberKey::INTEGER:  strjsonNumber(out, static_cast<Json::Int64>(key.bits)); break;
+		case NumberKey::UNSIGNED: strjsonNumber(out, key.bits);                           break;
+		default:                  strjsonNumber(out, n);                                  break;
+	}
+}
@@ -0,0 +1,63 @@
+#ifndef __JSONKEY_HPP__
+#define __JSONKEY_HPP__
+
+#include <string>
+#include <cstddef>
+
+namespace Json {
+
+	/// A precomputed key for looking up members of a JSON Object.
+	/**
+	 * Keys which are looked up repeatedly can be created once and
+	 * reused, which avoids measuring the key and creating a std::string
+	 * for it on every lookup:
+	 * @code
+	 * static const Json::Key kUser("user");
+	 * const Json::Value *user = doc.find(kUser);
+	 * @endcode
+	 *
+	 * @see Json::Value::find(const Json::Key&)
+	 */
+	class Key
+	{
+		private:
+			std::string str;
+
+		public:
+			/**
+			 * Creates a key from a null terminated string.
+			 *
+			 * @param key The name of the key.
+			 */
+			explicit Key(const char *key) : str(key) {}
+
+			/**
+			 * Creates a key from a string.
+			 *
+			 * @param key The name of the key.
+			 */
+			explicit Key(const std::string& key) : str(key) {}
+
+			/**
+			 * The name of the key.
+			 */
+			const std::string& name() const { return this->str; }
+
+			/**
+			 * The length of the name of the key.
+			 */
+			size_t length() const { return this->str.length(); }
+
+			bool operator==(const Key& k) const
+			{
+				return this->str == k.str;
+			}
+
+			bool operator!=(const Key& k) const
+			{
+				return !(*this == k);
+			}
+	};
+}
+
+#endif
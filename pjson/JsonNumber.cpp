@@ -0,0 +1,414 @@
+#include "JsonNumber.hpp"
+
+#include <cmath>
+#include <cstring>
+
+/*
+ * Shortest round-trip formatting of doubles, using the Grisu2 algorithm
+ * from "Printing Floating-Point Numbers Quickly and Accurately with
+ * Integers" by Florian Loitsch. Grisu2 finds the shortest digits in the
+ * vast majority of cases, and digits which read back as the same double
+ * in all cases, using 64-bit integer arithmetic only.
+ */
+
+namespace {
+
+	/* A floating point number f * 2^e with a 64-bit significand. */
+	struct DiyFp
+	{
+		uint64_t f;
+		int      e;
+
+		DiyFp(uint64_t f, int e) : f(f), e(e) {}
+	};
+
+	DiyFp
+	sub(const DiyFp& x, const DiyFp& y)
+	{
+		return DiyFp(x.f - y.f, x.e);
+	}
+
+	/* The upper 64 bits of the 128-bit product, rounded. */
+	DiyFp
+	mul(const DiyFp& x, const DiyFp& y)
+	{
+		const uint64_t xlo = x.f & 0xFFFFFFFFu, xhi = x.f >> 32;
+		const uint64_t ylo = y.f & 0xFFFFFFFFu, yhi = y.f >> 32;
+
+		const uint64_t p0 = xlo * ylo;
+		const uint64_t p1 = xlo * yhi;
+		const uint64_t p2 = xhi * ylo;
+		const uint64_t p3 = xhi * yhi;
+
+		uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+		q += uint64_t(1) << 31;
+
+		return DiyFp(p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64);
+	}
+
+	DiyFp
+	normalize(DiyFp x)
+	{
+		while (0 == (x.f >> 63)) {
+			x.f <<= 1;
+			x.e--;
+		}
+		return x;
+	}
+
+	/*
+	 * The double v, and the boundaries half way to its neighbours,
+	 * normalized to one exponent.
+	 */
+	struct Boundaries
+	{
+		DiyFp w, minus, plus;
+
+		Boundaries(double v) : w(0, 0), minus(0, 0), plus(0, 0)
+		{
+			const uint64_t hidden = uint64_t(1) << 52;
+			const int      bias   = 1023 + 52;
+
+			uint64_t bits;
+			std::memcpy(&bits, &v, sizeof(bits));
+			const uint64_t F = bits & (hidden - 1);
+			const int      E = bits >> 52 & 0x7FF;
+
+			DiyFp x = (0 == E) ? DiyFp(F, 1 - bias) : DiyFp(F + hidden, E - bias);
+
+			/* The lower neighbour is closer when v is a power of two. */
+			bool closer = (0 == F && E > 1);
+
+			this->plus  = normalize(DiyFp(2 * x.f + 1, x.e - 1));
+			this->minus = closer ? DiyFp(4 * x.f - 1, x.e - 2) : DiyFp(2 * x.f - 1, x.e - 1);
+			this->minus = DiyFp(this->minus.f << (this->minus.e - this->plus.e), this->plus.e);
+			this->w     = normalize(x);
+		}
+	};
+
+	struct CachedPower
+	{
+		uint64_t f;
+		int      e;
+		int      k;
+	};
+
+	/* Normalized 10^k for every eighth k from -348 to 340. */
+	const CachedPower cachedPowers[] = {
+{ 0xFA8FD5A0081C0288ULL, -1220, -348 },
+	{ 0xBAAEE17FA23EBF76ULL, -1193, -340 },
+	{ 0x8B16FB203055AC76ULL, -1166, -332 },
+	{ 0xCF42894A5DCE35EAULL, -1140, -324 },
+	{ 0x9A6BB0AA55653B2DULL, -1113, -316 },
+	{ 0xE61ACF033D1A45DFULL, -1087, -308 },
+	{ 0xAB70FE17C79AC6CAULL, -1060, -300 },
+	{ 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+	{ 0xBE5691EF416BD60CULL, -1007, -284 },
+	{ 0x8DD01FAD907FFC3CULL,  -980, -276 },
+	{ 0xD3515C2831559A83ULL,  -954, -268 },
+	{ 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+	{ 0xEA9C227723EE8BCBULL,  -901, -252 },
+	{ 0xAECC49914078536DULL,  -874, -244 },
+	{ 0x823C12795DB6CE57ULL,  -847, -236 },
+	{ 0xC21094364DFB5637ULL,  -821, -228 },
+	{ 0x9096EA6F3848984FULL,  -794, -220 },
+	{ 0xD77485CB25823AC7ULL,  -768, -212 },
+	{ 0xA086CFCD97BF97F4ULL,  -741, -204 },
+	{ 0xEF340A98172AACE5ULL,  -715, -196 },
+	{ 0xB23867FB2A35B28EULL,  -688, -188 },
+	{ 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+	{ 0xC5DD44271AD3CDBAULL,  -635, -172 },
+	{ 0x936B9FCEBB25C996ULL,  -608, -164 },
+	{ 0xDBAC6C247D62A584ULL,  -582, -156 },
+	{ 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+	{ 0xF3E2F893DEC3F126ULL,  -529, -140 },
+	{ 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+	{ 0x87625F056C7C4A8BULL,  -475, -124 },
+	{ 0xC9BCFF6034C13053ULL,  -449, -116 },
+	{ 0x964E858C91BA2655ULL,  -422, -108 },
+	{ 0xDFF9772470297EBDULL,  -396, -100 },
+	{ 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+	{ 0xF8A95FCF88747D94ULL,  -343,  -84 },
+	{ 0xB94470938FA89BCFULL,  -316,  -76 },
+	{ 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+	{ 0xCDB02555653131B6ULL,  -263,  -60 },
+	{ 0x993FE2C6D07B7FACULL,  -236,  -52 },
+	{ 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+	{ 0xAA242499697392D3ULL,  -183,  -36 },
+	{ 0xFD87B5F28300CA0EULL,  -157,  -28 },
+	{ 0xBCE5086492111AEBULL,  -130,  -20 },
+	{ 0x8CBCCC096F5088CCULL,  -103,  -12 },
+	{ 0xD1B71758E219652CULL,   -77,   -4 },
+	{ 0x9C40000000000000ULL,   -50,    4 },
+	{ 0xE8D4A51000000000ULL,   -24,   12 },
+	{ 0xAD78EBC5AC620000ULL,     3,   20 },
+	{ 0x813F3978F8940984ULL,    30,   28 },
+	{ 0xC097CE7BC90715B3ULL,    56,   36 },
+	{ 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+	{ 0xD5D238A4ABE98068ULL,   109,   52 },
+	{ 0x9F4F2726179A2245ULL,   136,   60 },
+	{ 0xED63A231D4C4FB27ULL,   162,   68 },
+	{ 0xB0DE65388CC8ADA8ULL,   189,   76 },
+	{ 0x83C7088E1AAB65DBULL,   216,   84 },
+	{ 0xC45D1DF942711D9AULL,   242,   92 },
+	{ 0x924D692CA61BE758ULL,   269,  100 },
+	{ 0xDA01EE641A708DEAULL,   295,  108 },
+	{ 0xA26DA3999AEF774AULL,   322,  116 },
+	{ 0xF209787BB47D6B85ULL,   348,  124 },
+	{ 0xB454E4A179DD1877ULL,   375,  132 },
+	{ 0x865B86925B9BC5C2ULL,   402,  140 },
+	{ 0xC83553C5C8965D3DULL,   428,  148 },
+	{ 0x952AB45CFA97A0B3ULL,   455,  156 },
+	{ 0xDE469FBD99A05FE3ULL,   481,  164 },
+	{ 0xA59BC234DB398C25ULL,   508,  172 },
+	{ 0xF6C69A72A3989F5CULL,   534,  180 },
+	{ 0xB7DCBF5354E9BECEULL,   561,  188 },
+	{ 0x88FCF317F22241E2ULL,   588,  196 },
+	{ 0xCC20CE9BD35C78A5ULL,   614,  204 },
+	{ 0x98165AF37B2153DFULL,   641,  212 },
+	{ 0xE2A0B5DC971F303AULL,   667,  220 },
+	{ 0xA8D9D1535CE3B396ULL,   694,  228 },
+	{ 0xFB9B7CD9A4A7443CULL,   720,  236 },
+	{ 0xBB764C4CA7A44410ULL,   747,  244 },
+	{ 0x8BAB8EEFB6409C1AULL,   774,  252 },
+	{ 0xD01FEF10A657842CULL,   800,  260 },
+	{ 0x9B10A4E5E9913129ULL,   827,  268 },
+	{ 0xE7109BFBA19C0C9DULL,   853,  276 },
+	{ 0xAC2820D9623BF429ULL,   880,  284 },
+	{ 0x80444B5E7AA7CF85ULL,   907,  292 },
+	{ 0xBF21E44003ACDD2DULL,   933,  300 },
+	{ 0x8E679C2F5E44FF8FULL,   960,  308 },
+	{ 0xD433179D9C8CB841ULL,   986,  316 },
+	{ 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+	{ 0xEB96BF6EBADF77D9ULL,  1039,  332 },
+	{ 0xAF87023B9BF0EE6BULL,  1066,  340 },
+	};
+
+	const int cachedPowersMinExp = -348;
+	const int cachedPowersStep   = 8;
+
+	/* The range the product of w and the cached power is brought into. */
+	const int alphaExp = -60;
+	const int gammaExp = -32;
+
+	/*
+	 * Finds the cached power c = f * 2^e = 10^k for which
+	 * alphaExp <= e + exp + 64 <= gammaExp.
+	 */
+	const CachedPower&
+	cachedPower(int exp)
+	{
+		/* ceil((alphaExp - exp - 1) * log10(2)) */
+		const int f = alphaExp - exp - 1;
+		const int k = (f * 78913) / (1 << 18) + (f > 0);
+		const int index = (-cachedPowersMinExp + k + (cachedPowersStep - 1)) / cachedPowersStep;
+
+		return cachedPowers[index];
+	}
+
+	/*
+	 * Moves the last digit towards w while the digits stay within
+	 * the boundaries, so the closest of the shortest candidates is used.
+	 */
+	void
+	roundDigits(char *buf, int length, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten)
+	{
+		while (rest < dist && delta - rest >= ten &&
+		       (rest + ten < dist || dist - rest > rest + ten - dist)) {
+			buf[length - 1]--;
+			rest += ten;
+		}
+	}
+
+	/*
+	 * Generates the shortest digits of a number in [minus, plus],
+	 * where buf * 10^exponent is the result.
+	 */
+	void
+	generateDigits(char *buf, int& length, int& exponent, const DiyFp& minus, const DiyFp& w, const DiyFp& plus)
+	{
+		uint64_t delta = sub(plus, minus).f;
+		uint64_t dist  = sub(plus, w).f;
+
+		const DiyFp one(uint64_t(1) << -plus.e, plus.e);
+
+		uint32_t p1 = static_cast<uint32_t>(plus.f >> -one.e);
+		uint64_t p2 = plus.f & (one.f - 1);
+
+		/* Digits of the integral part. */
+		uint32_t pow10 = 1;
+		int n = 1;
+		while (n < 10 && pow10 * 10 <= p1) {
+			pow10 *= 10;
+			n++;
+		}
+
+		while (n > 0) {
+			buf[length++] = static_cast<char>('0' + p1 / pow10);
+			p1 %= pow10;
+			n--;
+
+			uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+			if (rest <= delta) {
+				exponent += n;
+				roundDigits(buf, length, dist, delta, rest, uint64_t(pow10) << -one.e);
+				return;
+			}
+			pow10 /= 10;
+		}
+
+		/* Digits of the fractional part. */
+		int m = 0;
+		for (;;) {
+			p2 *= 10;
+			buf[length++] = static_cast<char>('0' + (p2 >> -one.e));
+			p2 &= one.f - 1;
+			m++;
+
+			delta *= 10;
+			dist  *= 10;
+			if (p2 <= delta) break;
+		}
+
+		exponent -= m;
+		roundDigits(buf, length, dist, delta, p2, one.f);
+	}
+
+	/* Writes the digits of v > 0 to buf, such that v = buf * 10^exponent. */
+	void
+	grisu2(char *buf, int& length, int& exponent, double v)
+	{
+		const Boundaries b(v);
+		const CachedPower& cached = cachedPower(b.plus.e);
+		const DiyFp c(cached.f, cached.e);
+
+		const DiyFp w     = mul(b.w, c);
+		const DiyFp minus = mul(b.minus, c);
+		const DiyFp plus  = mul(b.plus, c);
+
+		/* Shrink the interval by one unit each side, to be safe from the rounding in mul. */
+		length   = 0;
+		exponent = -cached.k;
+		generateDigits(buf, length, exponent, DiyFp(minus.f + 1, minus.e), w, DiyFp(plus.f - 1, plus.e));
+	}
+
+	const char digitPairs[] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
+	/* Writes 'exponent' as e+X or e-X. */
+	size_t
+	formatExponent(char *buf, int exponent)
+	{
+		size_t length = 0;
+		buf[length++] = 'e';
+		buf[length++] = exponent < 0 ? '-' : '+';
+		return length + Json::formatInteger(buf + length, int64_t(exponent < 0 ? -exponent : exponent));
+	}
+}
+
+size_t
+Json::formatInteger(char *buf, uint64_t i)
+{
+	char tmp[20];
+	char *p = tmp + sizeof(tmp);
+
+	/* Two digits at a time, from the least significant end. */
+	while (i >= 100) {
+		const unsigned pair = static_cast<unsigned>(i % 100) * 2;
+		i /= 100;
+		*--p = digitPairs[pair + 1];
+		*--p = digitPairs[pair];
+	}
+	if (i >= 10) {
+		const unsigned pair = static_cast<unsigned>(i) * 2;
+		*--p = digitPairs[pair + 1];
+		*--p = digitPairs[pair];
+	} else {
+		*--p = static_cast<char>('0' + i);
+	}
+
+	const size_t length = tmp + sizeof(tmp) - p;
+	std::memcpy(buf, p, length);
+	return length;
+}
+
+size_t
+Json::formatInteger(char *buf, int64_t i)
+{
+	if (i >= 0) return formatInteger(buf, uint64_t(i));
+
+	buf[0] = '-';
+	return 1 + formatInteger(buf + 1, uint64_t(0) - uint64_t(i));
+}
+
+size_t
+Json::formatNumber(char *buf, double n)
+{
+	if (!std::isfinite(n)) {
+		std::memcpy(buf, "null", 4);
+		return 4;
+	}
+
+	size_t length = 0;
+	if (std::signbit(n)) {
+		buf[length++] = '-';
+		n = -n;
+	}
+
+	if (0 == n) {
+		buf[length++] = '0';
+		return length;
+	}
+
+	char digits[20];
+	int count, exponent;
+	grisu2(digits, count, exponent, n);
+
+	/* The position of the decimal point, relative to the first digit. */
+	const int point = count + exponent;
+	char *out = buf + length;
+
+	if (count <= point && point <= 21) {
+		/* Integral: 1234500 */
+		std::memcpy(out, digits, count);
+		std::memset(out + count, '0', point - count);
+		return length + point;
+	}
+
+	if (0 < point && point <= 21) {
+		/* Fractional, with an integral part: 12.345 */
+		std::memcpy(out, digits, point);
+		out[point] = '.';
+		std::memcpy(out + point + 1, digits + point, count - point);
+		return length + count + 1;
+	}
+
+	if (-6 < point && point <= 0) {
+		/* Fractional, below one: 0.0012345 */
+		out[0] = '0';
+		out[1] = '.';
+		std::memset(out + 2, '0', -point);
+		std::memcpy(out + 2 - point, digits, count);
+		return length + 2 - point + count;
+	}
+
+	/* Exponential: 1.2345e+30 */
+	size_t written = 0;
+	out[written++] = digits[0];
+	if (count > 1) {
+		out[written++] = '.';
+		std::memcpy(out + written, digits + 1, count - 1);
+		written += count - 1;
+	}
+	written += formatExponent(out + written, point - 1);
+	return length + written;
+}
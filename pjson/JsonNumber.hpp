@@ -0,0 +1,39 @@
+#ifndef __JSONNUMBER_HPP__
+#define __JSONNUMBER_HPP__
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace Json {
+
+	/**
+	 * The largest number of characters written by formatInteger()
+	 * and formatNumber().
+	 */
+	const size_t NUMBER_BUFFER_SIZE = 32;
+
+	/**
+	 * Writes the decimal representation of 'i' to 'buf'.
+	 *
+	 * @param buf Where to write, at least NUMBER_BUFFER_SIZE characters.
+	 * @param i   The integer to write.
+	 * @returns The number of characters written. No null terminator is written.
+	 */
+	size_t formatInteger(char *buf, int64_t i);
+	size_t formatInteger(char *buf, uint64_t i);
+
+	/**
+	 * Writes the shortest decimal representation of 'n' which reads
+	 * back as exactly 'n' to 'buf'. Numbers are written like ECMAScript
+	 * writes them: without exponent from 1e-6 up to 1e21, e.g. 4200 or
+	 * 0.001, and as e.g. 1.5e+300 otherwise. NaN and infinities, which
+	 * JSON can not represent, are written as null.
+	 *
+	 * @param buf Where to write, at least NUMBER_BUFFER_SIZE characters.
+	 * @param n   The number to write.
+	 * @returns The number of characters written. No null terminator is written.
+	 */
+	size_t formatNumber(char *buf, double n);
+}
+
+#endif
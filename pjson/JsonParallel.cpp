@@ -0,0 +1,363 @@
+#include "JsonParallel.hpp"
+
+#include <algorithm>
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+Json::ThreadPool::ThreadPool(size_t threads)
+	: stopping(false)
+{
+	if (0 == threads) threads = std::max(1u, std::thread::hardware_concurrency());
+	for (size_t i = 0; i < threads; ++i) {
+		this->threads.push_back(std::thread(&Json::ThreadPool::work, this));
+	}
+}
+
+Json::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->queued.notify_all();
+
+	for (size_t i = 0; i < this->threads.size(); ++i) {
+		this->threads[i].join();
+	}
+}
+
+bool
+Json::ThreadPool::runOne(std::unique_lock<std::mutex>& lock)
+{
+	if (this->queue.empty()) return false;
+
+	Task task(std::move(this->queue.front()));
+	this->queue.pop_front();
+
+	lock.unlock();
+	task();
+	lock.lock();
+	return true;
+}
+
+void
+Json::ThreadPool::work()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	for (;;) {
+		if (this->runOne(lock)) continue;
+		if (this->stopping) return;
+		this->queued.wait(lock);
+	}
+}
+
+void
+Json::ThreadPool::run(std::vector<Task>& tasks) throw (Json::Exception)
+{
+	/* The tasks of this call; the pool may be running others too. */
+	struct Batch
+	{
+		size_t                  remaining;
+		const char             *error;
+		std::condition_variable done;
+	} batch;
+	batch.remaining = tasks.size();
+	batch.error     = NULL;
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	for (size_t i = 0; i < tasks.size(); ++i) {
+		Task& task = tasks[i];
+		this->queue.push_back([this, &batch, &task] {
+			const char *error = NULL;
+			try {
+				task();
+			} catch (const Json::Exception& e) {
+				error = e.what();
+			} catch (...) {
+				error = "Task failed.";
+			}
+
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (NULL == batch.error) batch.error = error;
+			if (0 == --batch.remaining) batch.done.notify_all();
+		});
+	}
+	this->queued.notify_all();
+
+	while (batch.remaining > 0) {
+		if (!this->runOne(lock)) batch.done.wait(lock);
+	}
+
+	if (NULL != batch.error) throw Json::Exception(batch.error);
+}
+
+namespace Json {
+
+	/**
+	 * Splits a value into pieces of output, and tasks which write them.
+	 * Writing the pieces in order gives the same output as strjson().
+	 */
+	class ParallelWriter
+	{
+		public:
+			/** The output, in order. Each piece is written by one task or by plan(). */
+			std::deque<std::string>          pieces;
+			std::vector<Json::ThreadPool::Task> tasks;
+
+			ParallelWriter(strformat format, size_t threads)
+				: format(format), threads(threads)
+			{
+				this->pieces.emplace_back();
+			}
+
+			/**
+			 * Plans the serialization of 'v', at depth 'indent'.
+			 */
+			void plan(const Json::Value& v, size_t indent)
+			{
+				Json::Value::StrjsonContext ctx = this->context(indent);
+				if (v.strjsonKept(ctx)) return;
+
+				size_t size = members(v);
+				if (size < Json::PARALLEL_GRAIN) {
+					v.strjson(ctx);
+					return;
+				}
+
+				/* Enough tasks for every thread to get several, so that they even out. */
+				size_t chunk = std::max(Json::PARALLEL_GRAIN, size / (8 * this->threads));
+
+				const Json::Shared<Json::PackedArray<double> > *doubles =
+					boost::get<Json::Shared<Json::PackedArray<double> > >(&v.value);
+				const Json::Shared<Json::PackedArray<int64_t> > *ints =
+					boost::get<Json::Shared<Json::PackedArray<int64_t> > >(&v.value);
+
+				if (NULL != doubles) {
+					this->packed(doubles->get().values, chunk, indent);
+				} else if (NULL != ints) {
+					this->packed(ints->get().values, chunk, indent);
+				} else if (JVOBJECT == v.getType()) {
+					this->object(v.asObject(), chunk, indent);
+				} else {
+					this->array(v.asArray(), chunk, indent);
+				}
+			}
+
+		private:
+			strformat format;
+			size_t    threads;
+
+			static size_t members(const Json::Value& v)
+			{
+				if (JVOBJECT == v.getType()) return v.asObject().size();
+				if (JVARRAY != v.getType()) return 0;
+
+				const Json::Shared<Json::PackedArray<double> > *doubles =
+					boost::get<Json::Shared<Json::PackedArray<double> > >(&v.value);
+				if (NULL != doubles) return doubles->get().values.size();
+
+				const Json::Shared<Json::PackedArray<int64_t> > *ints =
+					boost::get<Json::Shared<Json::PackedArray<int64_t> > >(&v.value);
+				if (NULL != ints) return ints->get().values.size();
+
+				return v.asArray().size();
+			}
+
+			/**
+			 * A context appending to the last piece, at depth 'indent'.
+			 */
+			Json::Value::StrjsonContext context(size_t indent)
+			{
+				Json::Value::StrjsonContext ctx(this->pieces.back(), this->format);
+				ctx.indent = indent;
+				return ctx;
+			}
+
+			/**
+			 * Adds a task writing into a piece of its own, and starts the
+			 * piece which comes after it.
+			 */
+			template <class F> void
+			task(size_t indent, F write)
+			{
+				std::string *piece = &this->pieces.back();
+				if (!piece->empty()) {
+					this->pieces.emplace_back();
+					piece = &this->pieces.back();
+				}
+
+				strformat format = this->format;
+				this->tasks.push_back([piece, format, indent, write] {
+					Json::Value::StrjsonContext ctx(*piece, format);
+					ctx.indent = indent;
+					write(ctx);
+				});
+				this->pieces.emplace_back();
+			}
+
+			void object(const Json::Object& obj, size_t chunk, size_t indent)
+			{
+				typedef Json::Object::const_iterator objit;
+
+				Json::Value::StrjsonContext open = this->context(indent);
+				Json::Value::strjsonOpen(open, '{');
+
+				objit begin = obj.begin(), from = begin;
+				size_t count = 0;
+				for (objit it = begin; it != obj.end(); ++it) {
+					bool large = members(it->second) >= Json::PARALLEL_GRAIN;
+					if (large || count == chunk) {
+						this->objectRange(begin, from, it, indent + 1);
+						from  = it;
+						count = 0;
+					}
+					if (!large) {
+						count++;
+						continue;
+					}
+
+					Json::Value::StrjsonContext ctx = this->context(indent + 1);
+					Json::Value::strjsonSeparator(ctx, it == begin);
+					Json::Value::strjsonString(ctx.out, it->first);
+					ctx.out += ctx.colon;
+					this->plan(it->second, indent + 1);
+					from = std::next(it);
+				}
+				this->objectRange(begin, from, obj.end(), indent + 1);
+
+				Json::Value::StrjsonContext close = this->context(indent + 1);
+				Json::Value::strjsonClose(close, '}');
+			}
+
+			void objectRange(Json::Object::const_iterator begin, Json::Object::const_iterator first,
+			                 Json::Object::const_iterator last, size_t indent)
+			{
+				if (first == last) return;
+
+				this->task(indent, [begin, first, last](Json::Value::StrjsonContext& ctx) {
+					for (Json::Object::const_iterator it = first; it != last; ++it) {
+						Json::Value::strjsonSeparator(ctx, it == begin);
+						Json::Value::strjsonString(ctx.out, it->first);
+						ctx.out += ctx.colon;
+						it->second.strjson(ctx);
+					}
+				});
+			}
+
+			void array(const Json::Array& arr, size_t chunk, size_t indent)
+			{
+				Json::Value::StrjsonContext open = this->context(indent);
+				Json::Value::strjsonOpen(open, '[');
+
+				size_t from = 0;
+				for (size_t i = 0; i < arr.size(); ++i) {
+					bool large = members(arr[i]) >= Json::PARALLEL_GRAIN;
+					if (large || i - from == chunk) {
+						this->arrayRange(arr, from, i, indent + 1);
+						from = i;
+					}
+					if (!large) continue;
+
+					Json::Value::StrjsonContext ctx = this->context(indent + 1);
+					Json::Value::strjsonSeparator(ctx, 0 == i);
+					this->plan(arr[i], indent + 1);
+					from = i + 1;
+				}
+				this->arrayRange(arr, from, arr.size(), indent + 1);
+
+				Json::Value::StrjsonContext close = this->context(indent + 1);
+				Json::Value::strjsonClose(close, ']');
+			}
+
+			void arrayRange(const Json::Array& arr, size_t first, size_t last, size_t indent)
+			{
+				if (first == last) return;
+
+				const Json::Value *members = arr.data();
+				this->task(indent, [members, first, last](Json::Value::StrjsonContext& ctx) {
+					for (size_t i = first; i < last; ++i) {
+						Json::Value::strjsonSeparator(ctx, 0 == i);
+						members[i].strjson(ctx);
+					}
+				});
+			}
+
+			template <class T> void
+			packed(const std::vector<T>& values, size_t chunk, size_t indent)
+			{
+				Json::Value::StrjsonContext open = this->context(indent);
+				Json::Value::strjsonOpen(open, '[');
+
+				const T *data = values.data();
+				for (size_t first = 0; first < values.size(); first += chunk) {
+					size_t last = std::min(values.size(), first + chunk);
+					this->task(indent + 1, [data, first, last](Json::Value::StrjsonContext& ctx) {
+						for (size_t i = first; i < last; ++i) {
+							Json::Value::strjsonSeparator(ctx, 0 == i);
+							Json::Value::strjsonNumber(ctx.out, data[i]);
+						}
+					});
+				}
+
+				Json::Value::StrjsonContext close = this->context(indent + 1);
+				Json::Value::strjsonClose(close, ']');
+			}
+	};
+}
+
+void
+Json::serialize(const Json::Value& value, std::string& out, strformat format, Json::ThreadPool& pool) throw (Json::Exception)
+{
+	Json::ParallelWriter writer(format, pool.size());
+	writer.plan(value, 0);
+	pool.run(writer.tasks);
+
+	size_t length = out.length();
+	for (size_t i = 0; i < writer.pieces.size(); ++i) length += writer.pieces[i].length();
+	out.reserve(length);
+
+	for (size_t i = 0; i < writer.pieces.size(); ++i) {
+		out += writer.pieces[i];
+		std::string().swap(writer.pieces[i]);
+	}
+}
+
+void
+Json::serialize(const Json::Value& value, int fd, strformat format, Json::ThreadPool& pool) throw (Json::Exception)
+{
+	Json::ParallelWriter writer(format, pool.size());
+	writer.plan(value, 0);
+	pool.run(writer.tasks);
+
+	std::vector<struct iovec> iov;
+	for (size_t i = 0; i < writer.pieces.size(); ++i) {
+		if (writer.pieces[i].empty()) continue;
+
+		struct iovec v = { const_cast<char*>(writer.pieces[i].data()), writer.pieces[i].length() };
+		iov.push_back(v);
+	}
+
+	struct iovec *next = iov.data(), *end = iov.data() + iov.size();
+	while (next != end) {
+		ssize_t n = ::writev(fd, next, std::min<ptrdiff_t>(end - next, IOV_MAX));
+		if (n < 0) {
+			if (EINTR == errno) continue;
+			throw Json::Exception("Could not write to file descriptor.");
+		}
+
+		/* Skip what was written, which may end within a buffer. */
+		while (n > 0 && static_cast<size_t>(n) >= next->iov_len) {
+			n -= next->iov_len;
+			next++;
+		}
+		if (n > 0) {
+			next->iov_base = static_cast<char*>(next->iov_base) + n;
+			next->iov_len -= n;
+		}
+	}
+}
@@ -0,0 +1,114 @@
+#ifndef __JSONPARALLEL_HPP__
+#define __JSONPARALLEL_HPP__
+
+#include "JsonValue.hpp"
+#include "JsonException.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Json {
+
+	/// A fixed set of threads running tasks.
+	/**
+	 * Used by the parallel Json::serialize overloads. One pool can be
+	 * shared by any number of serializations, from any number of threads.
+	 * @code
+	 * Json::ThreadPool pool;
+	 * std::string out;
+	 * Json::serialize(snapshot, out, Json::FORMAT_MINIFIED, pool);
+	 * @endcode
+	 */
+	class ThreadPool
+	{
+		public:
+			typedef std::function<void ()> Task;
+
+			/**
+			 * Starts the threads.
+			 *
+			 * @param threads How many threads to start. 0 starts
+			 *                one per hardware thread.
+			 */
+			explicit ThreadPool(size_t threads = 0);
+
+			/**
+			 * Waits for the tasks already queued and stops the threads.
+			 */
+			~ThreadPool();
+
+			/**
+			 * The number of threads in the pool.
+			 */
+			size_t size() const { return this->threads.size(); }
+
+			/**
+			 * Runs 'tasks' and returns once all of them are done. The
+			 * calling thread runs queued tasks too while it waits.
+			 *
+			 * @throws Json::Exception If a task threw one. The remaining
+			 *                         tasks still run.
+			 */
+			void run(std::vector<Task>& tasks) throw (Json::Exception);
+
+		private:
+			std::vector<std::thread> threads;
+			std::deque<Task>         queue;
+			std::mutex               mutex;
+			std::condition_variable  queued;
+			bool                     stopping;
+
+			void work();
+			bool runOne(std::unique_lock<std::mutex>& lock);
+
+			ThreadPool(const ThreadPool&);
+			ThreadPool& operator=(const ThreadPool&);
+	};
+
+	/**
+	 * Serializes 'value' using the threads of 'pool', appending it to 'out'.
+	 *
+	 * Objects and Arrays with at least Json::PARALLEL_GRAIN members are
+	 * split into ranges of members. Each range is written by a task into
+	 * a buffer of its own, and the buffers are appended to 'out' in order.
+	 * Members which are large themselves are split in turn. Smaller
+	 * values are written just as Json::serialize writes them, and so is
+	 * the output as a whole.
+	 *
+	 * @param value  The value to serialize.
+	 * @param out    The string to append the serialized value to.
+	 * @param format How to format the string.
+	 * @param pool   The threads to serialize with.
+	 * @throws Json::Exception if any error is encountered.
+	 */
+	void
+	serialize(const Json::Value& value, std::string& out, strformat format, Json::ThreadPool& pool) throw (Json::Exception);
+
+	/**
+	 * Serializes 'value' using the threads of 'pool', writing it to the
+	 * file descriptor 'fd'. The buffers written by the tasks are handed
+	 * to writev() as they are, without being concatenated first.
+	 *
+	 * @param value  The value to serialize.
+	 * @param fd     The file descriptor to write to. It is not closed.
+	 * @param format How to format the output.
+	 * @param pool   The threads to serialize with.
+	 * @throws Json::Exception if any error is encountered.
+	 * @see serialize(const Json::Value&, std::string&, strformat, Json::ThreadPool&)
+	 */
+	void
+	serialize(const Json::Value& value, int fd, strformat format, Json::ThreadPool& pool) throw (Json::Exception);
+
+	/**
+	 * The number of members below which an Object or Array is
+	 * serialized by a single task.
+	 */
+	static const size_t PARALLEL_GRAIN = 1024;
+}
+
+#endif
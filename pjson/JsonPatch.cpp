@@ -0,0 +1,328 @@
+#include "JsonPatch.hpp"
+#include "JsonBuilder.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/*
+ * Appends a reference token to the JSON Pointer 'path', escaping
+ * '~' as "~0" and '/' as "~1".
+ */
+static std::string
+pointer(const std::string& path, Json::StringView token)
+{
+	std::string p(path);
+	p += '/';
+	for (Json::StringView::const_iterator c = token.begin(); c != token.end(); ++c) {
+		if ('~' == *c) {
+			p += "~0";
+		} else if ('/' == *c) {
+			p += "~1";
+		} else {
+			p += *c;
+		}
+	}
+	return p;
+}
+
+static std::string
+pointer(const std::string& path, size_t index)
+{
+	return path + '/' + std::to_string(index);
+}
+
+static Json::Value
+operation(const char *op, const std::string& path)
+{
+	Json::Value o = Json::Builder::create(Json::value_t(Json::Object()));
+	o.set("op", Json::Builder::create(op));
+	o.set("path", Json::Builder::create(path));
+	return o;
+}
+
+static Json::Value
+operation(const char *op, const std::string& path, const Json::Value& value)
+{
+	Json::Value o = operation(op, path);
+	o.set("value", value);
+	return o;
+}
+
+static void
+diffObjects(Json::Value& patch, const std::string& path, const Json::Object& from, const Json::Object& to);
+
+static void
+diffArrays(Json::Value& patch, const std::string& path, const Json::Array& from, const Json::Array& to);
+
+/*
+ * Appends the operations turning 'from', at 'path', into 'to' to 'patch'.
+ */
+static void
+diff(Json::Value& patch, const std::string& path, const Json::Value& from, const Json::Value& to)
+{
+	if (from == to) return;
+
+	if (Json::JVOBJECT == from.getType() && Json::JVOBJECT == to.getType()) {
+		diffObjects(patch, path, from.asObject(), to.asObject());
+	} else if (Json::JVARRAY == from.getType() && Json::JVARRAY == to.getType()) {
+		diffArrays(patch, path, from.asArray(), to.asArray());
+	} else {
+		patch.push_back(operation("replace", path, to));
+	}
+}
+
+static void
+diffObjects(Json::Value& patch, const std::string& path, const Json::Object& from, const Json::Object& to)
+{
+	/* Both are ordered by key. */
+	Json::Object::const_iterator i = from.begin(), j = to.begin();
+	while (i != from.end() || j != to.end()) {
+		if (j == to.end() || (i != from.end() && i->first < j->first)) {
+			patch.push_back(operation("remove", pointer(path, i->first)));
+			++i;
+		} else if (i == from.end() || j->first < i->first) {
+			patch.push_back(operation("add", pointer(path, j->first), j->second));
+			++j;
+		} else {
+			diff(patch, pointer(path, i->first), i->second, j->second);
+			++i;
+			++j;
+		}
+	}
+}
+
+static void
+diffArrays(Json::Value& patch, const std::string& path, const Json::Array& from, const Json::Array& to)
+{
+	size_t n = from.size(), m = to.size();
+
+	/* The members both start and end with are left alone. */
+	size_t prefix = 0, suffix = 0;
+	while (prefix < n && prefix < m && from[prefix] == to[prefix]) prefix++;
+	while (suffix < n - prefix && suffix < m - prefix && from[n - 1 - suffix] == to[m - 1 - suffix]) suffix++;
+
+	size_t removed = n - prefix - suffix, added = m - prefix - suffix;
+	size_t common  = std::min(removed, added);
+
+	for (size_t i = 0; i < common; ++i) {
+		diff(patch, pointer(path, prefix + i), from[prefix + i], to[prefix + i]);
+	}
+	for (size_t i = common; i < removed; ++i) {
+		patch.push_back(operation("remove", pointer(path, prefix + common)));
+	}
+	for (size_t i = common; i < added; ++i) {
+		patch.push_back(operation("add", pointer(path, prefix + i), to[prefix + i]));
+	}
+}
+
+Json::Value
+Json::diff(const Json::Value& from, const Json::Value& to) throw (Json::Exception)
+{
+	Json::Value patch = Json::Builder::create(Json::value_t(Json::Array()));
+	::diff(patch, std::string(), from, to);
+	return patch;
+}
+
+/*
+ * The reference tokens of a JSON Pointer, with "~1" and "~0" replaced
+ * by '/' and '~'. The empty pointer, referring to the whole document,
+ * has none.
+ */
+typedef std::vector<std::string> Pointer;
+
+static Pointer
+parsePointer(const Json::Value& operation, const char *member) throw (Json::Exception)
+{
+	const Json::Value *location = operation.find(member);
+	if (NULL == location || Json::JVSTRING != location->getType()) {
+		throw Json::Exception("Patch operation is missing a location.");
+	}
+
+	Json::StringView str = location->asStringView();
+	if (!str.empty() && '/' != str[0]) throw Json::Exception("JSON Pointer does not start with '/'.");
+
+	Pointer tokens;
+	for (size_t i = 0; i < str.length(); ++i) {
+		if ('/' == str[i]) {
+			tokens.push_back(std::string());
+		} else if ('~' == str[i]) {
+			if (i + 1 == str.length() || ('0' != str[i + 1] && '1' != str[i + 1])) {
+				throw Json::Exception("Invalid escape sequence in JSON Pointer.");
+			}
+			tokens.back() += ('0' == str[++i]) ? '~' : '/';
+		} else {
+			tokens.back() += str[i];
+		}
+	}
+	return tokens;
+}
+
+/*
+ * The Array index 'token' refers to in an Array of 'size' members.
+ * With 'append', "-" and 'size' refer to the end of the Array.
+ */
+static size_t
+arrayIndex(const std::string& token, size_t size, bool append) throw (Json::Exception)
+{
+	if (append && "-" == token) return size;
+
+	if (token.empty() || token.length() > 18 || ('0' == token[0] && token.length() > 1) ||
+	    std::string::npos != token.find_first_not_of("0123456789")) {
+		throw Json::Exception("Invalid Array index in JSON Pointer.");
+	}
+
+	size_t index = std::stoull(token);
+	if (index > size || (index == size && !append)) throw Json::Exception("Array index out of range.");
+	return index;
+}
+
+/*
+ * The number of members of the Array 'v'.
+ */
+static size_t
+arraySize(const Json::Value& v)
+{
+	return v.asArray().size();
+}
+
+/*
+ * The value the first 'depth' tokens of 'path' refer to. Through a
+ * non-const 'root' the Objects and Arrays on the way are made
+ * modifiable, i.e. copied if they are shared.
+ */
+template <class V> static V&
+locate(V& root, const Pointer& path, size_t depth) throw (Json::Exception)
+{
+	V *v = &root;
+	for (size_t i = 0; i < depth; ++i) {
+		if (Json::JVOBJECT == v->getType()) {
+			if (NULL == v->find(path[i])) throw Json::Exception("Location does not exist.");
+			v = &(*v)[Json::Key(path[i])];
+		} else if (Json::JVARRAY == v->getType()) {
+			v = &(*v)[static_cast<int>(arrayIndex(path[i], arraySize(*v), false))];
+		} else {
+			throw Json::Exception("Location does not exist.");
+		}
+	}
+	return *v;
+}
+
+static void
+add(Json::Value& root, const Pointer& path, const Json::Value& value) throw (Json::Exception)
+{
+	if (path.empty()) {
+		root = value;
+		return;
+	}
+
+	Json::Value& parent = locate(root, path, path.size() - 1);
+	if (Json::JVOBJECT == parent.getType()) {
+		parent.set(path.back(), value);
+	} else if (Json::JVARRAY == parent.getType()) {
+		parent.insert(static_cast<int>(arrayIndex(path.back(), arraySize(parent), true)), value);
+	} else {
+		throw Json::Exception("Location does not exist.");
+	}
+}
+
+static Json::Value
+remove(Json::Value& root, const Pointer& path) throw (Json::Exception)
+{
+	if (path.empty()) throw Json::Exception("The whole document can not be removed.");
+
+	Json::Value& parent = locate(root, path, path.size() - 1);
+	Json::Value removed;
+	if (Json::JVOBJECT == parent.getType()) {
+		const Json::Value *member = parent.find(path.back());
+		if (NULL == member) throw Json::Exception("Location does not exist.");
+		removed = *member;
+		parent.erase(path.back());
+	} else if (Json::JVARRAY == parent.getType()) {
+		int index = static_cast<int>(arrayIndex(path.back(), arraySize(parent), false));
+		removed = *parent.find(index);
+		parent.erase(index);
+	} else {
+		throw Json::Exception("Location does not exist.");
+	}
+	return removed;
+}
+
+static const Json::Value&
+operand(const Json::Value& operation) throw (Json::Exception)
+{
+	const Json::Value *value = operation.find("value");
+	if (NULL == value) throw Json::Exception("Patch operation is missing a value.");
+	return *value;
+}
+
+static void
+apply(Json::Value& root, const Json::Value& operation) throw (Json::Exception)
+{
+	if (Json::JVOBJECT != operation.getType()) throw Json::Exception("Patch operation is not an Object.");
+
+	const Json::Value *op = operation.find("op");
+	if (NULL == op || Json::JVSTRING != op->getType()) throw Json::Exception("Patch operation has no 'op'.");
+
+	Json::StringView name = op->asStringView();
+	Pointer path = parsePointer(operation, "path");
+
+	if ("add" == name) {
+		add(root, path, operand(operation));
+	} else if ("remove" == name) {
+		remove(root, path);
+	} else if ("replace" == name) {
+		locate(root, path, path.size()) = operand(operation);
+	} else if ("move" == name) {
+		Pointer from = parsePointer(operation, "from");
+		if (from == path) return;
+		if (from.size() < path.size() && std::equal(from.begin(), from.end(), path.begin())) {
+			throw Json::Exception("A value can not be moved into itself.");
+		}
+		add(root, path, remove(root, from));
+	} else if ("copy" == name) {
+		Pointer from = parsePointer(operation, "from");
+		Json::Value copy = locate(static_cast<const Json::Value&>(root), from, from.size());
+		add(root, path, copy);
+	} else if ("test" == name) {
+		if (locate(static_cast<const Json::Value&>(root), path, path.size()) != operand(operation)) {
+			throw Json::Exception("Patch test failed.");
+		}
+	} else {
+		throw Json::Exception("Unknown patch operation.");
+	}
+}
+
+void
+Json::applyPatch(Json::Value& value, const Json::Value& patch) throw (Json::Exception)
+{
+	if (Json::JVARRAY != patch.getType()) throw Json::Exception("Patch is not an Array.");
+
+	/* Shares everything with 'value' until an operation modifies it. */
+	Json::Value result = value;
+	for (const Json::Value& operation : patch) {
+		apply(result, operation);
+	}
+	value = std::move(result);
+}
+
+void
+Json::mergePatch(Json::Value& value, const Json::Value& patch) throw (Json::Exception)
+{
+	if (Json::JVOBJECT != patch.getType()) {
+		value = patch;
+		return;
+	}
+
+	if (Json::JVOBJECT != value.getType()) value = Json::Builder::create(Json::value_t(Json::Object()));
+
+	for (Json::Object::const_iterator it = patch.asObject().begin(); it != patch.asObject().end(); ++it) {
+		if (it->second.isNull()) {
+			value.erase(it->first);
+		} else if (NULL == value.find(it->first)) {
+			Json::mergePatch(value.set(it->first, Json::Builder::create()), it->second);
+		} else {
+			Json::mergePatch(value[Json::Key(it->first)], it->second);
+		}
+	}
+}
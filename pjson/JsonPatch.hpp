@@ -0,0 +1,71 @@
+#ifndef __JSONPATCH_HPP__
+#define __JSONPATCH_HPP__
+
+#include "JsonValue.hpp"
+#include "JsonException.hpp"
+
+namespace Json {
+
+	/**
+	 * Computes a JSON Patch (RFC 6902) which turns 'from' into 'to'.
+	 * Applying it to 'from' with Json::applyPatch gives a value equal
+	 * to 'to':
+	 * @code
+	 * Json::Value patch = Json::diff(previous, state);
+	 * send(Json::serialize(patch, Json::FORMAT_MINIFIED));
+	 * @endcode
+	 *
+	 * Objects are compared member by member. Arrays are compared from
+	 * both ends; what differs in between is replaced member by member,
+	 * and members are removed or added at the end of that range. Any
+	 * other difference replaces the value as a whole.
+	 *
+	 * Values are compared with Json::Value::operator==, so Objects and
+	 * Arrays which 'to' shares with 'from', e.g. because 'to' is a
+	 * modified copy of 'from', are skipped at once. Diffing a large
+	 * state against its previous version thus takes time in proportion
+	 * to what changed.
+	 *
+	 * @param from The value the patch applies to.
+	 * @param to   The value the patch results in.
+	 * @returns The patch, an Array of operations. It is empty if the
+	 *          values are equal.
+	 */
+	Json::Value
+	diff(const Json::Value& from, const Json::Value& to) throw (Json::Exception);
+
+	/**
+	 * Applies a JSON Patch (RFC 6902) to 'value'. All operations are
+	 * supported: add, remove, replace, move, copy and test. Locations
+	 * are JSON Pointers (RFC 6901).
+	 *
+	 * Either the whole patch is applied or, if any operation fails,
+	 * none of it. Only the Objects and Arrays on the paths the patch
+	 * changes are copied, and only if they are shared.
+	 *
+	 * @param value The value to patch.
+	 * @param patch An Array of operations.
+	 * @throws Json::Exception If the patch is malformed, refers to a
+	 *                         location which does not exist, or a test
+	 *                         operation fails. 'value' is left as it was.
+	 */
+	void
+	applyPatch(Json::Value& value, const Json::Value& patch) throw (Json::Exception);
+
+	/**
+	 * Applies a JSON Merge Patch (RFC 7396) to 'value'. The members of
+	 * an Object patch are merged into 'value' recursively, members which
+	 * are null in the patch are removed, and any other patch replaces
+	 * 'value' as a whole:
+	 * @code
+	 * Json::mergePatch(config, Json::deserialize("{ \"log\" : { \"level\" : \"debug\" }, \"proxy\" : null }"));
+	 * @endcode
+	 *
+	 * @param value The value to patch.
+	 * @param patch The merge patch.
+	 */
+	void
+	mergePatch(Json::Value& value, const Json::Value& patch) throw (Json::Exception);
+}
+
+#endif
@@ -0,0 +1,491 @@
+#include "JsonReader.hpp"
+#include "JsonBuilder.hpp"
+#include "JsonTreeBuilder.hpp"
+
+#include <boost/lexical_cast.hpp>
+#include <cstring>
+#include <limits>
+
+Json::Reader::Reader(Json::StringView json)
+	: input(json),
+	  pos(json.data()),
+	  end(json.data() + json.length()),
+	  state(STATE_VALUE),
+	  peeked(false),
+	  peekedToken(TOKEN_END),
+	  text(json.data(), 0),
+	  integral(false),
+	  blank(0)
+{
+}
+
+Json::Reader::Token
+Json::Reader::next() throw (Json::Exception)
+{
+	if (this->peeked) {
+		this->peeked = false;
+		return this->peekedToken;
+	}
+	return this->read();
+}
+
+Json::Reader::Token
+Json::Reader::peek() throw (Json::Exception)
+{
+	if (!this->peeked) {
+		this->peekedToken = this->read();
+		this->peeked      = true;
+	}
+	return this->peekedToken;
+}
+
+void
+Json::Reader::skip() throw (Json::Exception)
+{
+	size_t depth = 0;
+	do {
+		switch (this->next()) {
+			case TOKEN_BEGIN_OBJECT:
+			case TOKEN_BEGIN_ARRAY:
+				depth++;
+				break;
+			case TOKEN_END_OBJECT:
+			case TOKEN_END_ARRAY:
+				depth--;
+				break;
+			case TOKEN_KEY:
+				continue;
+			case TOKEN_END:
+				throw Json::Exception("Unexpected end of input.");
+			default:
+				break;
+		}
+	} while (depth > 0);
+}
+
+Json::Value
+Json::Reader::tree(const std::shared_ptr<const std::string>& source) throw (Json::Exception)
+{
+	Json::TreeBuilder builder;
+
+	/*
+	 * Where each open Object and Array starts, and how much whitespace
+	 * had been skipped by then. If none was skipped by its end, it was
+	 * minified and can be kept as it is.
+	 */
+	std::vector<std::pair<const char*, size_t> > open;
+
+	do {
+		switch (this->next()) {
+			case TOKEN_BEGIN_OBJECT:
+				builder.beginObject();
+				open.push_back(std::make_pair(this->text.data(), this->blank));
+				break;
+
+			case TOKEN_BEGIN_ARRAY:
+				builder.beginArray();
+				open.push_back(std::make_pair(this->text.data(), this->blank));
+				break;
+
+			case TOKEN_END_OBJECT:
+			case TOKEN_END_ARRAY: {
+				if (open.empty()) throw Json::Exception("Expected a value.");
+
+				const char *begin = open.back().first;
+				if (source && open.back().second == this->blank) {
+					builder.end(Json::StringView(begin, this->text.data() + 1 - begin), source);
+				} else {
+					builder.end();
+				}
+				open.pop_back();
+				break;
+			}
+
+			case TOKEN_KEY:
+				if (open.empty()) throw Json::Exception("Expected a value.");
+				builder.key(this->str);
+				break;
+
+			case TOKEN_STRING:
+				builder.value(Json::Builder::create(std::string(this->str.data(), this->str.length())));
+				break;
+
+			case TOKEN_NUMBER: {
+				bool negative;
+				Json::UInt64 magnitude;
+				if (this->integral && integer(this->text, negative, magnitude)) {
+					if (!negative) {
+						builder.value(Json::Builder::create(magnitude));
+						break;
+					}
+					/* -0 is left to number(), as a double keeps its sign. */
+					if (0 != magnitude && magnitude <= static_cast<Json::UInt64>(std::numeric_limits<Json::Int64>::max()) + 1) {
+						builder.value(Json::Builder::create(this->int64()));
+						break;
+					}
+				}
+				builder.value(Json::Builder::create(this->number()));
+				break;
+			}
+
+			case TOKEN_BOOL:
+				builder.value(Json::Builder::create(this->boolean()));
+				break;
+
+			case TOKEN_NULL:
+				builder.value(Json::Builder::create());
+				break;
+
+			case TOKEN_END:
+				throw Json::Exception("Unexpected end of input.");
+		}
+	} while (0 != builder.depth());
+
+	return std::move(builder.result());
+}
+
+void
+Json::Reader::whitespace()
+{
+	const char *start = this->pos;
+	while (this->pos != this->end &&
+	       (' ' == *this->pos || '\t' == *this->pos || '\n' == *this->pos || '\r' == *this->pos)) {
+		this->pos++;
+	}
+	this->blank += this->pos - start;
+}
+
+Json::Reader::Token
+Json::Reader::read() throw (Json::Exception)
+{
+	this->whitespace();
+
+	if (STATE_DONE == this->state) {
+		if (this->pos != this->end) throw Json::Exception("Unexpected characters after the value.");
+		this->text = Json::StringView(this->pos, 0);
+		return TOKEN_END;
+	}
+
+	if (this->pos == this->end) throw Json::Exception("Unexpected end of input.");
+
+	const bool object = !this->stack.empty() && '{' == this->stack.back();
+	switch (this->state) {
+		case STATE_NEXT:
+			if (',' != *this->pos) return this->close();
+			this->pos++;
+			this->whitespace();
+			return object ? this->readKey() : this->readValue();
+
+		case STATE_FIRST:
+			if ((object ? '}' : ']') == *this->pos) return this->close();
+			return object ? this->readKey() : this->readValue();
+
+		default:
+			return this->readValue();
+	}
+}
+
+Json::Reader::Token
+Json::Reader::close() throw (Json::Exception)
+{
+	const char open = this->stack.back();
+	if ((('{' == open) ? '}' : ']') != *this->pos) {
+		throw Json::Exception(('{' == open) ? "Expected ',' or '}'." : "Expected ',' or ']'.");
+	}
+
+	this->text = Json::StringView(this->pos++, 1);
+	this->stack.pop_back();
+	this->state = this->stack.empty() ? STATE_DONE : STATE_NEXT;
+	return ('{' == open) ? TOKEN_END_OBJECT : TOKEN_END_ARRAY;
+}
+
+Json::Reader::Token
+Json::Reader::readKey() throw (Json::Exception)
+{
+	if (this->pos == this->end || '"' != *this->pos) throw Json::Exception("Expected a key.");
+	this->readString();
+
+	this->whitespace();
+	if (this->pos == this->end || ':' != *this->pos) throw Json::Exception("Expected ':'.");
+	this->pos++;
+
+	this->state = STATE_VALUE;
+	return TOKEN_KEY;
+}
+
+Json::Reader::Token
+Json::Reader::readValue() throw (Json::Exception)
+{
+	if (this->pos == this->end) throw Json::Exception("Unexpected end of input.");
+
+	Token token;
+	switch (*this->pos) {
+		case '{':
+		case '[':
+			this->text = Json::StringView(this->pos, 1);
+			this->stack.push_back(*this->pos++);
+			this->state = STATE_FIRST;
+			return ('{' == this->stack.back()) ? TOKEN_BEGIN_OBJECT : TOKEN_BEGIN_ARRAY;
+
+		case '"': this->readString();                 token = TOKEN_STRING; break;
+		case 't': this->readLiteral("true", 4);       token = TOKEN_BOOL;   break;
+		case 'f': this->readLiteral("false", 5);      token = TOKEN_BOOL;   break;
+		case 'n': this->readLiteral("null", 4);       token = TOKEN_NULL;   break;
+		default:  this->readNumber();                 token = TOKEN_NUMBER; break;
+	}
+
+	this->state = this->stack.empty() ? STATE_DONE : STATE_NEXT;
+	return token;
+}
+
+void
+Json::Reader::readLiteral(const char *literal, size_t length) throw (Json::Exception)
+{
+	if (static_cast<size_t>(this->end - this->pos) < length ||
+	    0 != std::memcmp(this->pos, literal, length)) {
+		throw Json::Exception("Invalid literal.");
+	}
+
+	this->text = Json::StringView(this->pos, length);
+	this->pos += length;
+}
+
+void
+Json::Reader::readString() throw (Json::Exception)
+{
+	const char *start = this->pos++;
+	bool escaped = false;
+
+	for (;;) {
+		if (this->pos == this->end) throw Json::Exception("String is not terminated.");
+
+		const unsigned char c = *this->pos;
+		if ('"' == c) break;
+		if (c < 0x20) throw Json::Exception("Control character in string.");
+		if ('\\' == c) {
+			escaped = true;
+			if (++this->pos == this->end) throw Json::Exception("String is not terminated.");
+			if ('\0' == *this->pos || NULL == strchr("\"\\/bfnrtu", *this->pos)) throw Json::Exception("Invalid escape sequence.");
+		}
+		this->pos++;
+	}
+	this->pos++;
+
+	this->text = Json::StringView(start, this->pos - start);
+	this->str  = Json::StringView(start + 1, this->text.length() - 2);
+
+	if (escaped) {
+		this->scratch.clear();
+		unescape(this->str, this->scratch);
+		this->str = Json::StringView(this->scratch);
+	}
+}
+
+static bool
+isDigit(const char *c, const char *end)
+{
+	return c != end && '0' <= *c && *c <= '9';
+}
+
+void
+Json::Reader::readNumber() throw (Json::Exception)
+{
+	/* -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)? */
+	const char *c = this->pos;
+	this->integral = true;
+
+	if (c != this->end && '-' == *c) c++;
+	if (!isDigit(c, this->end)) throw Json::Exception("Number value invalid.");
+	if ('0' == *c) {
+		c++;
+	} else {
+		while (isDigit(c, this->end)) c++;
+	}
+
+	if (c != this->end && '.' == *c) {
+		this->integral = false;
+		if (!isDigit(++c, this->end)) throw Json::Exception("Number value invalid.");
+		while (isDigit(c, this->end)) c++;
+	}
+
+	if (c != this->end && ('e' == *c || 'E' == *c)) {
+		this->integral = false;
+		c++;
+		if (c != this->end && ('+' == *c || '-' == *c)) c++;
+		if (!isDigit(c, this->end)) throw Json::Exception("Number value invalid.");
+		while (isDigit(c, this->end)) c++;
+	}
+
+	this->text = Json::StringView(this->pos, c - this->pos);
+	this->pos  = c;
+}
+
+bool
+Json::Reader::integer(Json::StringView text, bool& negative, Json::UInt64& magnitude)
+{
+	negative = !text.empty() && '-' == text[0];
+
+	size_t i = negative ? 1 : 0;
+	if (i == text.length()) return false;
+
+	const Json::UInt64 max = std::numeric_limits<Json::UInt64>::max();
+	magnitude = 0;
+	for (; i < text.length(); ++i) {
+		if (text[i] < '0' || text[i] > '9') return false;
+		unsigned digit = text[i] - '0';
+		if (magnitude > (max - digit) / 10) return false;
+		magnitude = magnitude * 10 + digit;
+	}
+	return true;
+}
+
+Json::Int64
+Json::Reader::int64() const throw (Json::Exception)
+{
+	bool negative;
+	Json::UInt64 magnitude;
+	const Json::UInt64 limit = static_cast<Json::UInt64>(std::numeric_limits<Json::Int64>::max());
+
+	if (!integer(this->text, negative, magnitude) || magnitude > limit + negative) {
+		throw Json::Exception("Number is not an integer which fits in Json::Int64.");
+	}
+
+	if (negative) return (magnitude == limit + 1) ? std::numeric_limits<Json::Int64>::min()
+	                                              : -static_cast<Json::Int64>(magnitude);
+	return magnitude;
+}
+
+Json::UInt64
+Json::Reader::uint64() const throw (Json::Exception)
+{
+	bool negative;
+	Json::UInt64 magnitude;
+	if (!integer(this->text, negative, magnitude) || (negative && 0 != magnitude)) {
+		throw Json::Exception("Number is not an integer which fits in Json::UInt64.");
+	}
+	return magnitude;
+}
+
+Json::Number
+Json::Reader::number() const throw (Json::Exception)
+{
+	static const double powers[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/*
+	 * Numbers with at most 15 digits and a small exponent are exact as
+	 * a double, and so is their product with (or quotient by) a power
+	 * of ten below 1e23. Everything else is converted in full.
+	 */
+	const char *c = this->text.data(), *end = c + this->text.length();
+	bool negative = ('-' == *c);
+	if (negative) c++;
+
+	Json::UInt64 mantissa = 0;
+	int digits = 0, exponent = 0;
+	for (; c != end && '0' <= *c && *c <= '9'; ++c, ++digits) mantissa = mantissa * 10 + (*c - '0');
+	if (c != end && '.' == *c) {
+		for (++c; c != end && '0' <= *c && *c <= '9'; ++c, ++digits, --exponent) {
+			mantissa = mantissa * 10 + (*c - '0');
+		}
+	}
+	if (c != end) {
+		bool negexp = ('-' == *++c);
+		if ('+' == *c || '-' == *c) c++;
+		int e = 0;
+		for (; c != end && e < 10000; ++c) e = e * 10 + (*c - '0');
+		exponent += negexp ? -e : e;
+	}
+
+	if (digits <= 15 && -22 <= exponent && exponent <= 22) {
+		double d = static_cast<double>(mantissa);
+		d = (exponent < 0) ? d / powers[-exponent] : d * powers[exponent];
+		return negative ? -d : d;
+	}
+
+	try {
+		return boost::lexical_cast<Json::Number>(this->text.data(), this->text.length());
+	} catch (boost::bad_lexical_cast) {}
+
+	throw Json::Exception("Number value invalid.");
+}
+
+static unsigned
+hexQuad(Json::StringView str, size_t pos) throw (Json::Exception)
+{
+	if (pos + 4 > str.length()) throw Json::Exception("Unicode escape too short.");
+
+	unsigned cp = 0;
+	for (size_t i = pos; i < pos + 4; ++i) {
+		char c = str[i];
+		cp <<= 4;
+		if      ('0' <= c && c <= '9') cp |= c - '0';
+		else if ('a' <= c && c <= 'f') cp |= c - 'a' + 10;
+		else if ('A' <= c && c <= 'F') cp |= c - 'A' + 10;
+		else throw Json::Exception("Unicode escape is not hexadecimal.");
+	}
+	return cp;
+}
+
+static void
+appendUtf8(std::string& str, unsigned cp)
+{
+	if (cp < 0x80) {
+		str += static_cast<char>(cp);
+	} else if (cp < 0x800) {
+		str += static_cast<char>(0xC0 | (cp >> 6));
+		str += static_cast<char>(0x80 | (cp & 0x3F));
+	} else if (cp < 0x10000) {
+		str += static_cast<char>(0xE0 | (cp >> 12));
+		str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		str += static_cast<char>(0x80 | (cp & 0x3F));
+	} else {
+		str += static_cast<char>(0xF0 | (cp >> 18));
+		str += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+		str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		str += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+}
+
+void
+Json::Reader::unescape(Json::StringView str, std::string& out) throw (Json::Exception)
+{
+	size_t pos = 0;
+	while (pos < str.length()) {
+		size_t backslash = str.find('\\', pos);
+		if (Json::StringView::npos == backslash || backslash + 1 == str.length()) {
+			out.append(str.data() + pos, str.length() - pos);
+			return;
+		}
+
+		out.append(str.data() + pos, backslash - pos);
+		char c = str[backslash + 1];
+		pos = backslash + 2;
+		switch (c) {
+			case 'b': out += '\b'; break;
+			case 'f': out += '\f'; break;
+			case 'n': out += '\n'; break;
+			case 'r': out += '\r'; break;
+			case 't': out += '\t'; break;
+			case 'u': {
+				unsigned cp = hexQuad(str, pos);
+				pos += 4;
+
+				/* Characters beyond the BMP are escaped as a surrogate pair. */
+				if (0xD800 <= cp && cp < 0xDC00 &&
+				    pos + 6 <= str.length() && '\\' == str[pos] && 'u' == str[pos + 1]) {
+					unsigned low = hexQuad(str, pos + 2);
+					if (0xDC00 <= low && low < 0xE000) {
+						cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+						pos += 6;
+					}
+				}
+				appendUtf8(out, cp);
+				break;
+			}
+			default: out += c; break;
+		}
+	}
+}
@@ -0,0 +1,194 @@
+#ifndef __JSONREADER_HPP__
+#define __JSONREADER_HPP__
+
+#include "JsonValue.hpp"
+#include "JsonException.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Json {
+
+	/// Reads JSON one token at a time.
+	/**
+	 * A pull parser: every call to next() reads one token of the input
+	 * and returns what it was. The contents of string, key and number
+	 * tokens are then available through string(), raw() and the
+	 * conversions. Nothing is allocated for them unless a string
+	 * contains escape sequences.
+	 * @code
+	 * Json::Reader r(json);
+	 * while (Json::Reader::TOKEN_END != r.next()) {
+	 *   ...
+	 * }
+	 * @endcode
+	 *
+	 * The structure is checked as it is read; input which is not valid
+	 * JSON makes next() throw Json::Exception.
+	 *
+	 * @note The input is not copied and must outlive the reader.
+	 */
+	class Reader
+	{
+		public:
+			/**
+			 * The kinds of tokens.
+			 */
+			enum Token {
+				TOKEN_BEGIN_OBJECT,
+				TOKEN_END_OBJECT,
+				TOKEN_BEGIN_ARRAY,
+				TOKEN_END_ARRAY,
+				/** The key of an Object member, see string(). */
+				TOKEN_KEY,
+				/** See string(). */
+				TOKEN_STRING,
+				/** See raw() and the number conversions. */
+				TOKEN_NUMBER,
+				/** See boolean(). */
+				TOKEN_BOOL,
+				TOKEN_NULL,
+				/** The whole input has been read. */
+				TOKEN_END
+			};
+
+			/**
+			 * Reads from 'json'.
+			 *
+			 * @param json The JSON to read. Must outlive the reader.
+			 */
+			Reader(Json::StringView json);
+
+			/**
+			 * Reads the next token.
+			 *
+			 * @throws Json::Exception If the input is not valid JSON.
+			 * @returns The token read.
+			 */
+			Token next() throw (Json::Exception);
+
+			/**
+			 * Tells what the next call to next() will return,
+			 * without moving past it.
+			 */
+			Token peek() throw (Json::Exception);
+
+			/**
+			 * Moves past the next value, including all members if it
+			 * is an Object or Array.
+			 */
+			void skip() throw (Json::Exception);
+
+			/**
+			 * Reads the next value, including all members if it is an
+			 * Object or Array, into a Json::Value.
+			 *
+			 * @param source The buffer being read, if the Objects and
+			 *               Arrays read should keep their JSON; see
+			 *               Json::deserialize(std::string, strsource).
+			 *               The reader must read all of it.
+			 */
+			Json::Value tree(const std::shared_ptr<const std::string>& source = std::shared_ptr<const std::string>()) throw (Json::Exception);
+
+			/**
+			 * The contents of the current TOKEN_STRING or TOKEN_KEY,
+			 * with escape sequences replaced. Valid until the next call
+			 * to next() or peek().
+			 */
+			Json::StringView string() const { return this->str; }
+
+			/**
+			 * The input text of the current token. For strings this
+			 * includes the quotes and escape sequences.
+			 */
+			Json::StringView raw() const { return this->text; }
+
+			/**
+			 * The offset in the input where the current token starts.
+			 */
+			size_t offset() const { return this->text.data() - this->input.data(); }
+
+			/** Tells whether the current TOKEN_NUMBER is an integer. */
+			bool isInteger() const { return this->integral; }
+
+			/**
+			 * The current TOKEN_NUMBER as an integer.
+			 *
+			 * @throws Json::Exception If it is not an integer which fits.
+			 */
+			Json::Int64 int64() const throw (Json::Exception);
+			Json::UInt64 uint64() const throw (Json::Exception);
+
+			/**
+			 * The current TOKEN_NUMBER as a double.
+			 */
+			Json::Number number() const throw (Json::Exception);
+
+			/**
+			 * The current TOKEN_BOOL.
+			 */
+			bool boolean() const { return 't' == this->text[0]; }
+
+			/**
+			 * Replaces the escape sequences in 'in' by the characters they
+			 * represent, e.g. \\n by a newline and \\u00e9 by its UTF-8
+			 * encoding, and appends the result to 'out'.
+			 *
+			 * @throws Json::Exception If a \\u escape is invalid.
+			 */
+			static void unescape(Json::StringView in, std::string& out) throw (Json::Exception);
+
+			/**
+			 * Reads the integer in 'text', e.g. "-123".
+			 *
+			 * @param text      The integer, without anything around it.
+			 * @param negative  Set to whether it has a minus sign.
+			 * @param magnitude Set to its absolute value.
+			 * @returns False if text is not an integer or does not fit in 64 bits.
+			 */
+			static bool integer(Json::StringView text, bool& negative, Json::UInt64& magnitude);
+
+		private:
+			enum State {
+				/** A value is expected. */
+				STATE_VALUE,
+				/** An Object or Array was just opened. */
+				STATE_FIRST,
+				/** A member was just read. */
+				STATE_NEXT,
+				/** The root value was read. */
+				STATE_DONE
+			};
+
+			Json::StringView  input;
+			const char       *pos;
+			const char       *end;
+
+			/** '{' or '[' for each enclosing Object and Array. */
+			std::vector<char> stack;
+			State             state;
+
+			bool              peeked;
+			Token             peekedToken;
+
+			Json::StringView  text;
+			Json::StringView  str;
+			std::string       scratch;
+			bool              integral;
+
+			/** The number of whitespace characters skipped so far. */
+			size_t            blank;
+
+			void whitespace();
+			Token read() throw (Json::Exception);
+			Token readKey() throw (Json::Exception);
+			Token readValue() throw (Json::Exception);
+			Token close() throw (Json::Exception);
+			void readString() throw (Json::Exception);
+			void readNumber() throw (Json::Exception);
+			void readLiteral(const char *literal, size_t length) throw (Json::Exception);
+	};
+}
+
+#endif
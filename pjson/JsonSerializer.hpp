@@ -0,0 +1,324 @@
+#ifndef __JSONSERIALIZER_HPP__
+#define __JSONSERIALIZER_HPP__
+
+#include "JsonValue.hpp"
+#include "JsonBuilder.hpp"
+
+#include <boost/optional.hpp>
+#include <array>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Json {
+
+	/// Appends JSON to a serialization in progress.
+	/**
+	 * The building blocks Json::Serializer specializations write with.
+	 * Every function appends at the position described by the context,
+	 * in the format of the serialization.
+	 */
+	class Output
+	{
+		public:
+			/** The state of one serialization. */
+			typedef Json::Value::StrjsonContext Context;
+
+			/** Starts an Object ('{') or Array ('['). */
+			static void open(Context& ctx, char c) { Json::Value::strjsonOpen(ctx, c); }
+
+			/** Ends an Object ('}') or Array (']'). */
+			static void close(Context& ctx, char c) { Json::Value::strjsonClose(ctx, c); }
+
+			/** Starts the next member of an Array. */
+			static void member(Context& ctx, bool first) { Json::Value::strjsonSeparator(ctx, first); }
+
+			/** Starts the next member of an Object, writing its key. */
+			static void key(Context& ctx, bool first, Json::StringView key)
+			{
+				Json::Value::strjsonSeparator(ctx, first);
+				Json::Value::strjsonString(ctx.out, key);
+				ctx.out += ctx.colon;
+			}
+
+			static void string(Context& ctx, Json::StringView str) { Json::Value::strjsonString(ctx.out, str); }
+			static void number(Context& ctx, Json::Int64 i)        { Json::Value::strjsonNumber(ctx.out, i); }
+			static void number(Context& ctx, Json::UInt64 i)       { Json::Value::strjsonNumber(ctx.out, i); }
+			static void number(Context& ctx, Json::Number n)       { Json::Value::strjsonNumber(ctx.out, n); }
+			static void boolean(Context& ctx, bool b)              { ctx.out += (b ? "true" : "false"); }
+			static void null(Context& ctx)                         { ctx.out += "null"; }
+			static void raw(Context& ctx, Json::StringView json)   { ctx.out.append(json.data(), json.length()); }
+			static void value(Context& ctx, const Json::Value& v)  { v.strjson(ctx); }
+	};
+
+	/// Writes C++ values as JSON without building a Json::Value.
+	/**
+	 * Json::serialize writes its argument through Serializer<T>, which
+	 * is specialized for scalars, strings and the standard containers.
+	 * Those are written member by member straight into the output, so
+	 * nothing but the output itself is allocated:
+	 *  - bool, integral and floating point types
+	 *  - std::string, const char*, Json::StringView
+	 *  - std::map<std::string, T> and std::unordered_map<std::string, T>
+	 *  - std::vector<T> and std::array<T, N>
+	 *  - std::pair and std::tuple, as Arrays
+	 *  - boost::optional<T>, as null when empty
+	 *  - Json::Value and Json::value_t
+	 *  - Json::RawJson, as it is
+	 *
+	 * Any other type is converted through Json::Builder::create first.
+	 * Serializer may be specialized for further types, writing them
+	 * through Json::Output:
+	 * @code
+	 * namespace Json {
+	 *   template <> struct Serializer<Point> {
+	 *     static void write(Output::Context& ctx, const Point& p) {
+	 *       Output::open(ctx, '{');
+	 *       Output::key(ctx, true, "x");  serializeTo(ctx, p.x);
+	 *       Output::key(ctx, false, "y"); serializeTo(ctx, p.y);
+	 *       Output::close(ctx, '}');
+	 *     }
+	 *   };
+	 * }
+	 * @endcode
+	 *
+	 * @tparam T The type to write.
+	 */
+	template <class T, class Enable>
+	struct Serializer
+	{
+		static void write(Json::Output::Context& ctx, const T& v)
+		{
+			Json::Output::value(ctx, Json::Builder::create(v));
+		}
+	};
+
+	/**
+	 * Appends 'v' at the position described by 'ctx'.
+	 */
+	template <class T> inline void
+	serializeTo(Json::Output::Context& ctx, const T& v)
+	{
+		Json::Serializer<T>::write(ctx, v);
+	}
+
+	template <>
+	struct Serializer<bool>
+	{
+		static void write(Json::Output::Context& ctx, bool v)
+		{
+			Json::Output::boolean(ctx, v);
+		}
+	};
+
+	template <class T>
+	struct Serializer<T, typename std::enable_if<std::is_integral<T>::value &&
+	                                             std::is_signed<T>::value>::type>
+	{
+		static void write(Json::Output::Context& ctx, T v)
+		{
+			Json::Output::number(ctx, Json::Int64(v));
+		}
+	};
+
+	template <class T>
+	struct Serializer<T, typename std::enable_if<std::is_integral<T>::value &&
+	                                             std::is_unsigned<T>::value &&
+	                                             !std::is_same<T, bool>::value>::type>
+	{
+		static void write(Json::Output::Context& ctx, T v)
+		{
+			Json::Output::number(ctx, Json::UInt64(v));
+		}
+	};
+
+	template <class T>
+	struct Serializer<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+	{
+		static void write(Json::Output::Context& ctx, T v)
+		{
+			Json::Output::number(ctx, Json::Number(v));
+		}
+	};
+
+	template <>
+	struct Serializer<Json::StringView>
+	{
+		static void write(Json::Output::Context& ctx, Json::StringView v)
+		{
+			Json::Output::string(ctx, v);
+		}
+	};
+
+	template <>
+	struct Serializer<std::string> : Serializer<Json::StringView> {};
+
+	template <>
+	struct Serializer<const char*> : Serializer<Json::StringView> {};
+
+	template <>
+	struct Serializer<char*> : Serializer<Json::StringView> {};
+
+	template <size_t N>
+	struct Serializer<char[N]> : Serializer<Json::StringView> {};
+
+	template <>
+	struct Serializer<Json::NullValue>
+	{
+		static void write(Json::Output::Context& ctx, const Json::NullValue&)
+		{
+			Json::Output::null(ctx);
+		}
+	};
+
+	template <>
+	struct Serializer<Json::RawJson>
+	{
+		static void write(Json::Output::Context& ctx, const Json::RawJson& v)
+		{
+			Json::Output::raw(ctx, v.json());
+		}
+	};
+
+	template <>
+	struct Serializer<Json::Value>
+	{
+		static void write(Json::Output::Context& ctx, const Json::Value& v)
+		{
+			Json::Output::value(ctx, v);
+		}
+	};
+
+	template <>
+	struct Serializer<Json::value_t>
+	{
+		struct Visitor : public boost::static_visitor<>
+		{
+			Json::Output::Context& ctx;
+
+			Visitor(Json::Output::Context& ctx) : ctx(ctx) {}
+
+			template <class T> void operator()(const T& v) const
+			{
+				Json::serializeTo(this->ctx, v);
+			}
+		};
+
+		static void write(Json::Output::Context& ctx, const Json::value_t& v)
+		{
+			boost::apply_visitor(Visitor(ctx), v);
+		}
+	};
+
+	/**
+	 * Writes the members of a Json::Object-like container.
+	 */
+	template <class Map>
+	struct MapSerializer
+	{
+		static void write(Json::Output::Context& ctx, const Map& m)
+		{
+			Json::Output::open(ctx, '{');
+			for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it) {
+				Json::Output::key(ctx, it == m.begin(), it->first);
+				Json::serializeTo(ctx, it->second);
+			}
+			Json::Output::close(ctx, '}');
+		}
+	};
+
+	/**
+	 * Writes the members of a Json::Array-like container.
+	 */
+	template <class Sequence>
+	struct SequenceSerializer
+	{
+		static void write(Json::Output::Context& ctx, const Sequence& s)
+		{
+			typedef typename Sequence::value_type T;
+
+			Json::Output::open(ctx, '[');
+			for (typename Sequence::const_iterator it = s.begin(); it != s.end(); ++it) {
+				Json::Output::member(ctx, it == s.begin());
+				Json::serializeTo<T>(ctx, *it);
+			}
+			Json::Output::close(ctx, ']');
+		}
+	};
+
+	template <class T, class C, class A>
+	struct Serializer<std::map<std::string, T, C, A> >
+		: MapSerializer<std::map<std::string, T, C, A> > {};
+
+	/**
+	 * @note The members are written in the order of the unordered_map.
+	 */
+	template <class T, class H, class E, class A>
+	struct Serializer<std::unordered_map<std::string, T, H, E, A> >
+		: MapSerializer<std::unordered_map<std::string, T, H, E, A> > {};
+
+	template <class T, class A>
+	struct Serializer<std::vector<T, A> >
+		: SequenceSerializer<std::vector<T, A> > {};
+
+	template <class T, size_t N>
+	struct Serializer<std::array<T, N> >
+		: SequenceSerializer<std::array<T, N> > {};
+
+	template <class T1, class T2>
+	struct Serializer<std::pair<T1, T2> >
+	{
+		static void write(Json::Output::Context& ctx, const std::pair<T1, T2>& p)
+		{
+			Json::Output::open(ctx, '[');
+			Json::Output::member(ctx, true);
+			Json::serializeTo(ctx, p.first);
+			Json::Output::member(ctx, false);
+			Json::serializeTo(ctx, p.second);
+			Json::Output::close(ctx, ']');
+		}
+	};
+
+	template <class... T>
+	struct Serializer<std::tuple<T...> >
+	{
+		template <size_t I>
+		static typename std::enable_if<I == sizeof...(T)>::type
+		members(Json::Output::Context&, const std::tuple<T...>&) {}
+
+		template <size_t I>
+		static typename std::enable_if<I < sizeof...(T)>::type
+		members(Json::Output::Context& ctx, const std::tuple<T...>& t)
+		{
+			Json::Output::member(ctx, 0 == I);
+			Json::serializeTo(ctx, std::get<I>(t));
+			members<I + 1>(ctx, t);
+		}
+
+		static void write(Json::Output::Context& ctx, const std::tuple<T...>& t)
+		{
+			Json::Output::open(ctx, '[');
+			members<0>(ctx, t);
+			Json::Output::close(ctx, ']');
+		}
+	};
+
+	template <class T>
+	struct Serializer<boost::optional<T> >
+	{
+		static void write(Json::Output::Context& ctx, const boost::optional<T>& v)
+		{
+			if (v) {
+				Json::serializeTo(ctx, *v);
+			} else {
+				Json::Output::null(ctx);
+			}
+		}
+	};
+}
+
+#endif
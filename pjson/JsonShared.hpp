@@ -0,0 +1,318 @@
+#ifndef __JSONSHARED_HPP__
+#define __JSONSHARED_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <utility>
+
+namespace Json {
+
+	/// Reference counted, copy-on-write storage.
+	/**
+	 * Holds an instance of T which is shared between all copies of
+	 * the Shared<T>. Copying a Shared<T> only increments an atomic
+	 * reference count. The held instance is copied first when it is
+	 * about to be modified through modify() or mutate() while other copies
+	 * still refer to it.
+	 *
+	 * Reading the same instance from several threads is safe, as is
+	 * copying, modifying and destroying different Shared<T> which
+	 * happen to refer to the same instance.
+	 *
+	 * Alongside the instance a few strings computed from it, e.g. its
+	 * serialization or the input it was parsed from, can be kept, see
+	 * memo(). They are dropped whenever the instance is modified
+	 * through modify() or mutate().
+	 *
+	 * The reference modify() returns is meant for one modification.
+	 * The reference mutate() returns may be written through at any
+	 * later time instead, so until settle() is called the instance is
+	 * not shared: copies of the Shared<T> hold copies of the instance,
+	 * and neither memos nor a digest are kept for it. Writing through
+	 * the reference thus neither changes a copy nor leaves anything
+	 * stale behind.
+	 *
+	 * @note T may be incomplete where Shared<T> is declared.
+	 *
+	 * @tparam T The type of the held instance.
+	 */
+	template <class T>
+	class Shared
+	{
+		public:
+			/**
+			 * A string computed from the held instance.
+			 */
+			struct Memo
+			{
+				/** What the string was computed for, beyond the instance itself. */
+				size_t      key;
+				const char *data;
+				size_t      length;
+
+				/** Holds the string, when it was kept as a copy. */
+				std::string copy;
+
+				/** Holds the buffer the string is part of otherwise. */
+				std::shared_ptr<const std::string> source;
+			};
+
+			/** The number of memos kept per instance. */
+			static const size_t MEMOS = 2;
+
+		private:
+			struct Node
+			{
+				std::atomic<size_t> refs;
+				T data;
+				std::atomic<Memo*> memos[MEMOS];
+				std::atomic<uint64_t> digest;
+
+				/** Whether mutate() has handed out a reference to 'data' since settle(). */
+				std::atomic<bool> exposed;
+
+				Node(const T& d) : refs(1), data(d), digest(0), exposed(false) { this->init(); }
+				Node(T&& d) : refs(1), data(std::move(d)), digest(0), exposed(false) { this->init(); }
+
+				~Node()
+				{
+					this->forget();
+				}
+
+				void init()
+				{
+					for (size_t i = 0; i < MEMOS; ++i) this->memos[i].store(NULL, std::memory_order_relaxed);
+				}
+
+				void forget()
+				{
+					for (size_t i = 0; i < MEMOS; ++i) {
+						delete this->memos[i].exchange(NULL, std::memory_order_relaxed);
+					}
+					this->digest.store(0, std::memory_order_relaxed);
+				}
+			};
+
+			Node *node;
+
+			void release()
+			{
+				if (NULL != this->node &&
+				    1 == this->node->refs.fetch_sub(1, std::memory_order_acq_rel)) {
+					delete this->node;
+				}
+			}
+
+			void keep(size_t slot, Memo *memo) const
+			{
+				/* A memo which may be read by another thread is never replaced. */
+				Memo *expected = NULL;
+				if (this->exposed() ||
+				    !this->node->memos[slot].compare_exchange_strong(expected, memo, std::memory_order_acq_rel)) {
+					delete memo;
+				}
+			}
+
+			bool exposed() const
+			{
+				return this->node->exposed.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * The node a copy of 's' refers to; a copy of its own if
+			 * the instance of 's' may still be written to.
+			 */
+			static Node *share(const Shared& s)
+			{
+				if (s.exposed()) return new Node(static_cast<const T&>(s.node->data));
+
+				s.node->refs.fetch_add(1, std::memory_order_relaxed);
+				return s.node;
+			}
+
+		public:
+			/**
+			 * Holds a default constructed T.
+			 */
+			Shared() : node(new Node(T())) {}
+
+			/**
+			 * Holds a copy of 'data'.
+			 */
+			explicit Shared(const T& data) : node(new Node(data)) {}
+
+			/**
+			 * Takes over 'data'.
+			 */
+			explicit Shared(T&& data) : node(new Node(std::move(data))) {}
+
+			Shared(const Shared& s) : node(share(s))
+			{
+			}
+
+			Shared(Shared&& s) noexcept : node(s.node)
+			{
+				s.node = NULL;
+			}
+
+			~Shared()
+			{
+				this->release();
+			}
+
+			Shared& operator=(const Shared& s)
+			{
+				if (this->node != s.node) {
+					Node *shared = share(s);
+					this->release();
+					this->node = shared;
+				}
+				return *this;
+			}
+
+			Shared& operator=(Shared&& s) noexcept
+			{
+				if (this != &s) {
+					this->release();
+					this->node = s.node;
+					s.node = NULL;
+				}
+				return *this;
+			}
+
+			/**
+			 * Read only access to the held instance.
+			 */
+			const T& get() const
+			{
+				return this->node->data;
+			}
+
+			/**
+			 * Write access to the held instance, for one modification.
+			 * If the instance is shared it is copied first, so no other
+			 * Shared<T> observes the modification, and whatever was kept
+			 * for it is dropped. The reference must not be written
+			 * through once this Shared<T> has been copied again.
+			 */
+			T& modify()
+			{
+				if (!this->unique()) {
+					Node *copy = new Node(static_cast<const T&>(this->node->data));
+					this->release();
+					this->node = copy;
+				} else {
+					this->node->forget();
+				}
+				return this->node->data;
+			}
+
+			/**
+			 * Same as modify(), but the reference stays safe to write
+			 * through for as long as this Shared<T> holds the instance:
+			 * until settle() is called, the instance is not shared again,
+			 * see above.
+			 */
+			T& mutate()
+			{
+				T& data = this->modify();
+				this->node->exposed.store(true, std::memory_order_relaxed);
+				return data;
+			}
+
+			/**
+			 * Ends what mutate() began: the instance is shared, and
+			 * memos and a digest are kept for it, again. References
+			 * mutate() returned must no longer be written through once
+			 * this Shared<T> is copied.
+			 */
+			void settle()
+			{
+				this->node->exposed.store(false, std::memory_order_relaxed);
+			}
+
+			/**
+			 * The memo kept in 'slot', or NULL if there is none.
+			 *
+			 * @param slot Which memo, below MEMOS.
+			 */
+			const Memo *memo(size_t slot) const
+			{
+				return this->node->memos[slot].load(std::memory_order_acquire);
+			}
+
+			/**
+			 * Keeps 'data' as the memo in 'slot', unless there is one
+			 * already or mutate() has been called since the last settle(). It is shared by all
+			 * copies of this Shared<T> until the instance is modified.
+			 *
+			 * @param slot Which memo, below MEMOS.
+			 * @param key  What 'data' was computed for, beyond the instance.
+			 * @param data The string to keep.
+			 */
+			void memoize(size_t slot, size_t key, std::string&& data) const
+			{
+				Memo *memo   = new Memo;
+				memo->key    = key;
+				memo->copy   = std::move(data);
+				memo->data   = memo->copy.data();
+				memo->length = memo->copy.length();
+				this->keep(slot, memo);
+			}
+
+			/**
+			 * Same as memoize(size_t, size_t, std::string&&), but the
+			 * string is not copied; it is the 'length' characters at
+			 * 'data', which are part of 'source'.
+			 */
+			void memoize(size_t slot, size_t key, const std::shared_ptr<const std::string>& source,
+			             const char *data, size_t length) const
+			{
+				Memo *memo   = new Memo;
+				memo->key    = key;
+				memo->data   = data;
+				memo->length = length;
+				memo->source = source;
+				this->keep(slot, memo);
+			}
+
+			/**
+			 * The digest kept by digest(uint64_t), or 0 if there is none.
+			 */
+			uint64_t digest() const
+			{
+				return this->node->digest.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * Keeps 'digest', computed from the held instance, until the
+			 * instance is modified. 0 is not kept, nor is anything between
+			 * a call to mutate() and the next settle().
+			 */
+			void digest(uint64_t digest) const
+			{
+				if (!this->exposed()) this->node->digest.store(digest, std::memory_order_relaxed);
+			}
+
+			/**
+			 * Tells whether 's' refers to the same instance.
+			 */
+			bool same(const Shared& s) const
+			{
+				return this->node == s.node;
+			}
+
+			/**
+			 * Tells whether this is the only reference to the held instance.
+			 */
+			bool unique() const
+			{
+				return 1 == this->node->refs.load(std::memory_order_acquire);
+			}
+	};
+}
+
+#endif
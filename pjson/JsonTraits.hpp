@@ -0,0 +1,267 @@
+#ifndef __JSONTRAITS_HPP__
+#define __JSONTRAITS_HPP__
+
+#include "JsonValue.hpp"
+#include "JsonBuilder.hpp"
+#include "JsonReader.hpp"
+#include "JsonSerializer.hpp"
+
+#include <boost/optional.hpp>
+#include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
+#include <boost/preprocessor/stringize.hpp>
+#include <boost/preprocessor/variadic/to_seq.hpp>
+#include <limits>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Json {
+
+	/// Reads C++ values straight from JSON tokens.
+	/**
+	 * Traits<T>::read(reader, value) reads the next value of the reader
+	 * into 'value', without building a Json::Value. It is specialized for
+	 * - bool, integral and floating point types
+	 * - std::string
+	 * - std::vector<T> and std::map<std::string, T>
+	 * - boost::optional<T>, which is left empty for null
+	 * - Json::Value, for parts of a document which have no fixed shape
+	 *
+	 * Structs are added with JSON_TRAITS, or by specializing Traits.
+	 *
+	 * @see Json::deserializeInto
+	 * @tparam T The type to read.
+	 */
+	template <class T, class Enable = void>
+	struct Traits;
+
+	/**
+	 * Throws unless 'token' is 'expected'.
+	 */
+	inline void
+	expectToken(Json::Reader::Token token, Json::Reader::Token expected, const char *error) throw (Json::Exception)
+	{
+		if (token != expected) throw Json::Exception(error);
+	}
+
+	/**
+	 * Reads an Object, calling 'member' with the key of each member.
+	 * 'member' either reads the value of the member and returns true,
+	 * or returns false to have the value skipped.
+	 *
+	 * @param r      The reader, positioned before the Object.
+	 * @param member Called as bool member(Json::StringView key).
+	 */
+	template <class F> void
+	readMembers(Json::Reader& r, F member) throw (Json::Exception)
+	{
+		expectToken(r.next(), Json::Reader::TOKEN_BEGIN_OBJECT, "Expected an Object.");
+		while (Json::Reader::TOKEN_KEY == r.next()) {
+			if (!member(r.string())) r.skip();
+		}
+	}
+
+	template <>
+	struct Traits<bool>
+	{
+		static void read(Json::Reader& r, bool& v) throw (Json::Exception)
+		{
+			expectToken(r.next(), Json::Reader::TOKEN_BOOL, "Expected a boolean.");
+			v = r.boolean();
+		}
+	};
+
+	template <class T>
+	struct Traits<T, typename std::enable_if<std::is_integral<T>::value &&
+	                                         std::is_signed<T>::value>::type>
+	{
+		static void read(Json::Reader& r, T& v) throw (Json::Exception)
+		{
+			expectToken(r.next(), Json::Reader::TOKEN_NUMBER, "Expected a number.");
+			Json::Int64 i = r.int64();
+			if (i < std::numeric_limits<T>::min() || i > std::numeric_limits<T>::max()) {
+				throw Json::Exception("Integer out of range.");
+			}
+			v = static_cast<T>(i);
+		}
+	};
+
+	template <class T>
+	struct Traits<T, typename std::enable_if<std::is_integral<T>::value &&
+	                                         std::is_unsigned<T>::value &&
+	                                         !std::is_same<T, bool>::value>::type>
+	{
+		static void read(Json::Reader& r, T& v) throw (Json::Exception)
+		{
+			expectToken(r.next(), Json::Reader::TOKEN_NUMBER, "Expected a number.");
+			Json::UInt64 i = r.uint64();
+			if (i > std::numeric_limits<T>::max()) throw Json::Exception("Integer out of range.");
+			v = static_cast<T>(i);
+		}
+	};
+
+	template <class T>
+	struct Traits<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+	{
+		static void read(Json::Reader& r, T& v) throw (Json::Exception)
+		{
+			expectToken(r.next(), Json::Reader::TOKEN_NUMBER, "Expected a number.");
+			v = static_cast<T>(r.number());
+		}
+	};
+
+	template <>
+	struct Traits<std::string>
+	{
+		static void read(Json::Reader& r, std::string& v) throw (Json::Exception)
+		{
+			expectToken(r.next(), Json::Reader::TOKEN_STRING, "Expected a string.");
+			Json::StringView str = r.string();
+			v.assign(str.data(), str.length());
+		}
+	};
+
+	template <class T, class A>
+	struct Traits<std::vector<T, A> >
+	{
+		static void read(Json::Reader& r, std::vector<T, A>& v) throw (Json::Exception)
+		{
+			expectToken(r.next(), Json::Reader::TOKEN_BEGIN_ARRAY, "Expected an Array.");
+			v.clear();
+			while (Json::Reader::TOKEN_END_ARRAY != r.peek()) {
+				v.emplace_back();
+				Json::Traits<T>::read(r, v.back());
+			}
+			r.next();
+		}
+	};
+
+	template <class T, class C, class A>
+	struct Traits<std::map<std::string, T, C, A> >
+	{
+		static void read(Json::Reader& r, std::map<std::string, T, C, A>& v) throw (Json::Exception)
+		{
+			v.clear();
+			readMembers(r, [&r, &v](Json::StringView key) {
+				Json::Traits<T>::read(r, v[std::string(key.data(), key.length())]);
+				return true;
+			});
+		}
+	};
+
+	template <class T>
+	struct Traits<boost::optional<T> >
+	{
+		static void read(Json::Reader& r, boost::optional<T>& v) throw (Json::Exception)
+		{
+			if (Json::Reader::TOKEN_NULL == r.peek()) {
+				r.next();
+				v = boost::none;
+				return;
+			}
+
+			T t;
+			Json::Traits<T>::read(r, t);
+			v = std::move(t);
+		}
+	};
+
+	template <>
+	struct Traits<Json::Value>
+	{
+		static void read(Json::Reader& r, Json::Value& v) throw (Json::Exception)
+		{
+			v = r.tree();
+		}
+	};
+
+	/**
+	 * Reads 'json' straight into 'out' through Json::Traits<T>. No
+	 * Json::Value is built. Members of Objects which T has no field
+	 * for are skipped, and fields missing from the input are left as
+	 * they were.
+	 * @code
+	 * struct Login { std::string user; int attempts; };
+	 * JSON_TRAITS(Login, user, attempts)
+	 *
+	 * Login l = Json::deserializeInto<Login>("{ \"user\" : \"bob\", \"attempts\" : 3 }");
+	 * @endcode
+	 *
+	 * @param json The JSON to read.
+	 * @param out  Where to read it into.
+	 * @throws Json::Exception If json is not valid JSON, or does not
+	 *                         match the shape of T.
+	 */
+	template <class T> void
+	deserializeInto(Json::StringView json, T& out) throw (Json::Exception)
+	{
+		Json::Reader r(json);
+		Json::Traits<T>::read(r, out);
+		r.next();
+	}
+
+	/**
+	 * Same as deserializeInto(Json::StringView, T&), but reads into
+	 * and returns a default constructed T.
+	 */
+	template <class T> T
+	deserializeInto(Json::StringView json) throw (Json::Exception)
+	{
+		T out;
+		deserializeInto(json, out);
+		return out;
+	}
+}
+
+/** @cond */
+#define JSON_TRAITS_READ(r_, v, field) \
+	if (key == BOOST_PP_STRINGIZE(field)) { \
+		Json::Traits<decltype(v.field)>::read(r, v.field); \
+		return true; \
+	}
+
+#define JSON_TRAITS_WRITE(r_, v, i, field) \
+	Json::Output::key(ctx, 0 == i, BOOST_PP_STRINGIZE(field)); \
+	Json::serializeTo(ctx, v.field);
+/** @endcond */
+
+/**
+ * Makes a struct readable by Json::deserializeInto and writable by
+ * Json::serialize, as an Object with one member per listed field:
+ * @code
+ * struct Point { int x; int y; };
+ * JSON_TRAITS(Point, x, y)
+ * @endcode
+ *
+ * Must be used outside of any namespace, with the fully qualified
+ * name of the struct. The fields may be of any type Json::Traits
+ * and Json::Serializer support, including other such structs.
+ */
+#define JSON_TRAITS(Type, ...) \
+	namespace Json { \
+		template <> \
+		struct Traits<Type> \
+		{ \
+			static void read(Json::Reader& r, Type& v) throw (Json::Exception) \
+			{ \
+				Json::readMembers(r, [&r, &v](Json::StringView key) -> bool { \
+					BOOST_PP_SEQ_FOR_EACH(JSON_TRAITS_READ, v, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)) \
+					return false; \
+				}); \
+			} \
+		}; \
+		template <> \
+		struct Serializer<Type> \
+		{ \
+			static void write(Json::Output::Context& ctx, const Type& v) \
+			{ \
+				Json::Output::open(ctx, '{'); \
+				BOOST_PP_SEQ_FOR_EACH_I(JSON_TRAITS_WRITE, v, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)) \
+				Json::Output::close(ctx, '}'); \
+			} \
+		}; \
+	}
+
+#endif
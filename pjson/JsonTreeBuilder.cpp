@@ -0,0 +1,92 @@
+#include "JsonTreeBuilder.hpp"
+
+Json::TreeBuilder::TreeBuilder()
+{
+}
+
+void
+Json::TreeBuilder::beginObject()
+{
+	this->stack.emplace_back();
+	this->stack.back().object = true;
+	this->stack.back().unique = true;
+}
+
+void
+Json::TreeBuilder::beginArray(size_t size)
+{
+	this->stack.emplace_back();
+	this->stack.back().object = false;
+	this->stack.back().unique = true;
+	this->stack.back().arr.reserve(size);
+}
+
+void
+Json::TreeBuilder::key(Json::StringView key)
+{
+	this->stack.back().key.assign(key.data(), key.length());
+}
+
+void
+Json::TreeBuilder::value(Json::Value&& v)
+{
+	this->add(std::move(v));
+}
+
+void
+Json::TreeBuilder::end()
+{
+	this->add(this->close());
+}
+
+void
+Json::TreeBuilder::end(Json::StringView raw, const std::shared_ptr<const std::string>& source)
+{
+	bool unique = this->stack.back().unique;
+
+	Json::Value v = this->close();
+	if (unique) v.keepSource(raw, source);
+	this->add(std::move(v));
+}
+
+Json::Value
+Json::TreeBuilder::close()
+{
+	Frame& frame = this->stack.back();
+
+	Json::Value v;
+	if (frame.object) {
+		v.type  = JVOBJECT;
+		v.value = Json::Shared<Json::Object>(std::move(frame.obj));
+	} else {
+		v.type  = JVARRAY;
+		v.value = Json::Value::store(std::move(frame.arr));
+	}
+
+	this->stack.pop_back();
+	return v;
+}
+
+void
+Json::TreeBuilder::add(Json::Value&& v)
+{
+	if (this->stack.empty()) {
+		this->root = std::move(v);
+		return;
+	}
+
+	Frame& frame = this->stack.back();
+	if (!frame.object) {
+		frame.arr.push_back(std::move(v));
+		return;
+	}
+
+	/* The last of duplicate keys wins, as it does when parsing into a Json::Value. */
+	Json::Object::iterator it = frame.obj.lower_bound(frame.key);
+	if (it != frame.obj.end() && it->first == frame.key) {
+		frame.unique = false;
+		it->second   = std::move(v);
+		return;
+	}
+	frame.obj.emplace_hint(it, std::move(frame.key), std::move(v));
+}
@@ -0,0 +1,89 @@
+#ifndef __JSONTREEBUILDER_HPP__
+#define __JSONTREEBUILDER_HPP__
+
+#include "JsonValue.hpp"
+#include "JsonException.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Json {
+
+	/// Builds a Json::Value from the structure a parser reads.
+	/**
+	 * A parser calls beginObject() or beginArray() when a container
+	 * opens, key() before each member of an Object, value() for every
+	 * other value and end() when the container closes. Once the root
+	 * value is complete it is taken with result().
+	 *
+	 * This keeps how the tree is put together in one place, whatever
+	 * format it is read from.
+	 */
+	class TreeBuilder
+	{
+		public:
+			TreeBuilder();
+
+			void beginObject();
+
+			/**
+			 * Opens an Array, making room for 'size' members if the
+			 * parser knows how many there are.
+			 */
+			void beginArray(size_t size = 0);
+
+			/**
+			 * The key of the next member of the current Object.
+			 */
+			void key(Json::StringView key);
+
+			/**
+			 * Adds a value which is not an Object or Array.
+			 */
+			void value(Json::Value&& v);
+
+			/**
+			 * Closes the current Object or Array, and adds it.
+			 */
+			void end();
+
+			/**
+			 * Same as end(), but keeps 'raw', the minified JSON the
+			 * container was parsed from, as its minified output. 'raw'
+			 * is part of 'source', which is kept alive along with it.
+			 * Nothing is kept for Objects with duplicate keys, as they
+			 * are not what was parsed.
+			 */
+			void end(Json::StringView raw, const std::shared_ptr<const std::string>& source);
+
+			/**
+			 * The number of open Objects and Arrays.
+			 */
+			size_t depth() const { return this->stack.size(); }
+
+			/**
+			 * The root value, once it is complete.
+			 */
+			Json::Value& result() { return this->root; }
+
+		private:
+			struct Frame
+			{
+				bool         object;
+				/** Whether no key of the Object occurred twice. */
+				bool         unique;
+				Json::Object obj;
+				Json::Array  arr;
+				std::string  key;
+			};
+
+			std::vector<Frame> stack;
+			Json::Value        root;
+
+			Json::Value close();
+			void add(Json::Value&& v);
+	};
+}
+
+#endif
@@ -1,27 +1,21 @@
 #include "JsonValue.hpp"
-#include <boost/lexical_cast.hpp>
+#include "JsonNumber.hpp"
+#include "JsonReader.hpp"
 #include <string>
+#include <utility>
+#include <limits>
+#include <cmath>
 #include <iostream>
-#include <sstream>
 
-static enum Json::Types
-ValueType(char firstchar)
-{
-	switch(firstchar) {
-		case '{': return Json::JVOBJECT;
-		case '[': return Json::JVARRAY;
-		case '"': return Json::JVSTRING;
-		case 'n': return Json::JVNULL;
-		case 't':
-		case 'f': return Json::JVBOOL;
-		default:  return Json::JVNUMBER;
-	}
-}
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 Json::Types
-Json::Value::typeByValue(Json::value_t v) throw (Json::Exception)
+Json::Value::typeByValue(const Json::value_t& v) throw (Json::Exception)
 {
-	if (v.type() == typeid(Json::String)) {
+	if (v.type() == typeid(Json::String) ||
+	    v.type() == typeid(Json::CString)) {
 		return Json::JVSTRING;
 	} else if (v.type() == typeid(Json::Bool)) {
 		return Json::JVBOOL;
@@ -30,34 +24,175 @@ Json::Value::typeByValue(Json::value_t v) throw (Json::Exception)
 	} else if (v.type() == typeid(Json::Array)) {
 		return Json::JVARRAY;
 	} else if (v.type() == typeid(Json::Int) ||
+	           v.type() == typeid(Json::Int64) ||
+	           v.type() == typeid(Json::UInt64) ||
 	           v.type() == typeid(Json::Number)) {
 		return Json::JVNUMBER;
 	} else if (v.type() == typeid(Json::NullValue)) {
 		return Json::JVNULL;
+	} else if (v.type() == typeid(Json::RawJson)) {
+		return Json::JVRAW;
 	}
 
 	throw Json::Exception("Invalid type.");
 }
 
-Json::Value::Value(std::string json, cmode m) throw (Json::Exception)
+template <class V> static void
+storeNumber(V& value, double n)
 {
-	switch (m) {
-		case MODE_PARSE:
-			std::string minified = this->minify(json);
-			this->parse(minified);
-			break;
+	value = Json::Number(n);
+}
+
+/*
+ * Integers are stored in the narrowest of Json::Int, Json::Int64 and
+ * Json::UInt64 which holds them, so each integer has one representation.
+ */
+template <class V> static void
+storeNumber(V& value, Json::Int64 n)
+{
+	if (n >= std::numeric_limits<Json::Int>::min() &&
+	    n <= std::numeric_limits<Json::Int>::max()) {
+		value = Json::Int(n);
+	} else {
+		value = n;
 	}
 }
 
-Json::Value::Value(Json::value_t v)
+template <class V> static void
+storeNumber(V& value, Json::UInt64 n)
 {
-	this->value = v;
+	if (n <= static_cast<Json::UInt64>(std::numeric_limits<Json::Int64>::max())) {
+		storeNumber(value, static_cast<Json::Int64>(n));
+	} else {
+		value = n;
+	}
+}
 
-	if (v.type() == typeid(const char*)) {
-		this->value = std::string(this->get<const char*>());
+namespace {
+	/**
+	 * Moves the alternative held by a Json::value_t into Json::Value storage.
+	 */
+	template <class storage_t>
+	class StoreVisitor : public boost::static_visitor<storage_t>
+	{
+		private:
+			size_t inline_max;
+
+		public:
+			StoreVisitor(size_t inline_max) : inline_max(inline_max) {}
+
+			storage_t operator()(Json::String& v) const
+			{
+				if (v.length() <= this->inline_max) return storage_t(std::move(v));
+				return storage_t(Json::Shared<Json::String>(std::move(v)));
+			}
+
+			storage_t operator()(Json::CString v) const
+			{
+				Json::String str(v);
+				return (*this)(str);
+			}
+
+			storage_t operator()(Json::Object& v) const
+			{
+				return storage_t(Json::Shared<Json::Object>(std::move(v)));
+			}
+
+			storage_t operator()(Json::Array& v) const
+			{
+				return storage_t(Json::Shared<Json::Array>(std::move(v)));
+			}
+
+			storage_t operator()(Json::Int64 v) const
+			{
+				storage_t s;
+				storeNumber(s, v);
+				return s;
+			}
+
+			storage_t operator()(Json::UInt64 v) const
+			{
+				storage_t s;
+				storeNumber(s, v);
+				return s;
+			}
+
+			template <class T> storage_t operator()(T& v) const
+			{
+				return storage_t(v);
+			}
+	};
+}
+
+Json::Value::storage_t
+Json::Value::store(Json::value_t& v)
+{
+	StoreVisitor<storage_t> visitor(INLINE_STRING_MAX);
+	return boost::apply_visitor(visitor, v);
+}
+
+Json::Value::storage_t
+Json::Value::store(Json::String&& str)
+{
+	if (str.length() <= INLINE_STRING_MAX) return storage_t(std::move(str));
+	return storage_t(Json::Shared<Json::String>(std::move(str)));
+}
+
+Json::Value::storage_t
+Json::Value::store(Json::Array&& arr)
+{
+	bool integers = true;
+	bool wide     = false;
+	Json::Array::const_iterator it;
+	for (it = arr.begin(); it != arr.end(); ++it) {
+		if (JVNUMBER != it->type) break;
+		/* Json::UInt64 is only used beyond the range of int64_t. */
+		integers = integers && it->isInteger() && it->value.type() != typeid(Json::UInt64);
+		wide     = wide || it->value.type() == typeid(Json::Int64) ||
+		                   it->value.type() == typeid(Json::UInt64);
 	}
 
-	this->type = Json::Value::typeByValue(this->value);
+	/* 64-bit integers are not packed as doubles, which would round them. */
+	if (arr.empty() || it != arr.end() || (wide && !integers)) {
+		return storage_t(Json::Shared<Json::Array>(std::move(arr)));
+	}
+
+	if (integers) {
+		std::vector<int64_t> packed;
+		packed.reserve(arr.size());
+		for (it = arr.begin(); it != arr.end(); ++it) packed.push_back(it->asInt64());
+		return storage_t(Json::Shared<Json::PackedArray<int64_t> >(Json::PackedArray<int64_t>(std::move(packed))));
+	}
+
+	std::vector<double> packed;
+	packed.reserve(arr.size());
+	for (it = arr.begin(); it != arr.end(); ++it) packed.push_back(it->asNumber());
+	return storage_t(Json::Shared<Json::PackedArray<double> >(Json::PackedArray<double>(std::move(packed))));
+}
+
+Json::Value::Value(std::vector<double>&& v)
+	: value(Json::Shared<Json::PackedArray<double> >(Json::PackedArray<double>(std::move(v)))),
+	  type(JVARRAY)
+{
+}
+
+Json::Value::Value(std::vector<int64_t>&& v)
+	: value(Json::Shared<Json::PackedArray<int64_t> >(Json::PackedArray<int64_t>(std::move(v)))),
+	  type(JVARRAY)
+{
+}
+
+Json::Value::Value(const Json::value_t& v)
+{
+	Json::value_t copy(v);
+	this->value = Json::Value::store(copy);
+	this->type  = Json::Value::typeByValue(v);
+}
+
+Json::Value::Value(Json::value_t&& v)
+{
+	this->type  = Json::Value::typeByValue(v);
+	this->value = Json::Value::store(v);
 }
 
 Json::Value::Value()
@@ -74,45 +209,220 @@ Json::Value::getType() const
 bool
 Json::Value::objectHasKey(const char *key) const
 {
-	try {
-		Object obj = this->asObject();
-		return (obj.find(key) != obj.end());
-	} catch (Json::Exception& e) {
-		return false;
-	}
+	return NULL != this->find(key);
 }
 
 bool
 Json::Value::arrayHasKey(int key) const
 {
-	try {
-		Array arr = this->asArray();
-		Json::Value v = arr.at(key);
-		return true;
-	} catch (Json::Exception) {
-		return false;
-	} catch (std::out_of_range) {
-		return false;
-	}
+	return NULL != this->find(key);
 }
 
 template<class T> T
 Json::Value::get() const throw (Json::Exception)
 {
-	try {
-		return boost::get<T>(this->value);
-	} catch (boost::bad_get) {
-		throw Json::Exception("Invalid cast.");
+	return this->ref<T>();
+}
+
+template<class T> const T&
+Json::Value::ref() const throw (Json::Exception)
+{
+	const T *v = boost::get<T>(&this->value);
+	if (NULL == v) throw Json::Exception("Invalid cast.");
+
+	return *v;
+}
+
+template<class T> T&
+Json::Value::ref() throw (Json::Exception)
+{
+	T *v = boost::get<T>(&this->value);
+	if (NULL == v) throw Json::Exception("Invalid cast.");
+
+	return *v;
+}
+
+namespace Json {
+	template<> const Json::String&
+	Value::ref<Json::String>() const throw (Json::Exception)
+	{
+		const Json::String *str = boost::get<Json::String>(&this->value);
+		if (NULL != str) return *str;
+
+		const Json::Shared<Json::String> *shared = boost::get<Json::Shared<Json::String> >(&this->value);
+		if (NULL == shared) throw Json::Exception("Invalid cast.");
+
+		return shared->get();
+	}
+
+	template<> Json::String&
+	Value::ref<Json::String>() throw (Json::Exception)
+	{
+		Json::String *str = boost::get<Json::String>(&this->value);
+		if (NULL != str) return *str;
+
+		Json::Shared<Json::String> *shared = boost::get<Json::Shared<Json::String> >(&this->value);
+		if (NULL == shared) throw Json::Exception("Invalid cast.");
+
+		return shared->mutate();
+	}
+
+	template<> const Json::Object&
+	Value::ref<Json::Object>() const throw (Json::Exception)
+	{
+		const Json::Shared<Json::Object> *shared = boost::get<Json::Shared<Json::Object> >(&this->value);
+		if (NULL == shared) throw Json::Exception("Invalid cast.");
+
+		return shared->get();
+	}
+
+	template<> Json::Shared<Json::Object>&
+	Value::storage<Json::Object>() throw (Json::Exception)
+	{
+		Json::Shared<Json::Object> *shared = boost::get<Json::Shared<Json::Object> >(&this->value);
+		if (NULL == shared) throw Json::Exception("Invalid cast.");
+
+		return *shared;
+	}
+
+	template<> Json::Object&
+	Value::ref<Json::Object>() throw (Json::Exception)
+	{
+		return this->storage<Json::Object>().mutate();
 	}
 
-	return boost::get<T>(this->value);
+	template<> const Json::Array&
+	Value::ref<Json::Array>() const throw (Json::Exception)
+	{
+		const Json::Array *arr = this->array();
+		if (NULL == arr) throw Json::Exception("Invalid cast.");
+
+		return *arr;
+	}
+
+	template<> Json::Shared<Json::Array>&
+	Value::storage<Json::Array>() throw (Json::Exception)
+	{
+		if (JVARRAY != this->type) throw Json::Exception("Invalid cast.");
+
+		Json::Shared<Json::Array> *shared = boost::get<Json::Shared<Json::Array> >(&this->value);
+		if (NULL == shared) {
+			/* A packed Array is unpacked before it is modified. */
+			this->value = Json::Shared<Json::Array>(Json::Array(*this->array()));
+			shared = boost::get<Json::Shared<Json::Array> >(&this->value);
+		}
+
+		return *shared;
+	}
+
+	template<> Json::Array&
+	Value::ref<Json::Array>() throw (Json::Exception)
+	{
+		return this->storage<Json::Array>().mutate();
+	}
+}
+
+template<class T> const Json::Array&
+Json::Value::expand(const Json::PackedArray<T>& packed)
+{
+	Json::Array *arr = packed.expanded.load(std::memory_order_acquire);
+	if (NULL != arr) return *arr;
+
+	arr = new Json::Array(packed.values.size());
+	for (size_t i = 0; i < packed.values.size(); ++i) {
+		Json::Value& v = (*arr)[i];
+		v.type = JVNUMBER;
+		storeNumber(v.value, packed.values[i]);
+	}
+
+	/* Another thread may have expanded the same Array meanwhile. */
+	Json::Array *expected = NULL;
+	if (!packed.expanded.compare_exchange_strong(expected, arr, std::memory_order_acq_rel)) {
+		delete arr;
+		return *expected;
+	}
+
+	return *arr;
+}
+
+const Json::Array*
+Json::Value::array() const
+{
+	const Json::Shared<Json::Array> *shared = boost::get<Json::Shared<Json::Array> >(&this->value);
+	if (NULL != shared) return &shared->get();
+
+	const Json::Shared<Json::PackedArray<double> > *doubles =
+		boost::get<Json::Shared<Json::PackedArray<double> > >(&this->value);
+	if (NULL != doubles) return &Json::Value::expand(doubles->get());
+
+	const Json::Shared<Json::PackedArray<int64_t> > *ints =
+		boost::get<Json::Shared<Json::PackedArray<int64_t> > >(&this->value);
+	if (NULL != ints) return &Json::Value::expand(ints->get());
+
+	return NULL;
+}
+
+Json::DoubleSpan
+Json::Value::asDoubleSpan() const throw (Json::Exception)
+{
+	const Json::Shared<Json::PackedArray<double> > *doubles =
+		boost::get<Json::Shared<Json::PackedArray<double> > >(&this->value);
+	if (NULL == doubles) throw Json::Exception("Array is not packed as doubles.");
+
+	const std::vector<double>& v = doubles->get().values;
+	return Json::DoubleSpan(v.data(), v.data() + v.size());
 }
 
-Json::Value
+Json::IntSpan
+Json::Value::asIntSpan() const throw (Json::Exception)
+{
+	const Json::Shared<Json::PackedArray<int64_t> > *ints =
+		boost::get<Json::Shared<Json::PackedArray<int64_t> > >(&this->value);
+	if (NULL == ints) throw Json::Exception("Array is not packed as integers.");
+
+	const std::vector<int64_t>& v = ints->get().values;
+	return Json::IntSpan(v.data(), v.data() + v.size());
+}
+
+const Json::Value*
+Json::Value::find(Json::StringView key) const
+{
+	const Json::Shared<Json::Object> *shared = boost::get<Json::Shared<Json::Object> >(&this->value);
+	if (NULL == shared) return NULL;
+
+	const Json::Object *obj = &shared->get();
+
+	Json::Object::const_iterator it = obj->find(key);
+	return (it == obj->end()) ? NULL : &it->second;
+}
+
+const Json::Value*
+Json::Value::find(int key) const
+{
+	const Json::Array *arr = this->array();
+	if (NULL == arr) return NULL;
+
+	if (key < 0 || static_cast<size_t>(key) >= arr->size()) return NULL;
+
+	return &(*arr)[key];
+}
+
+const Json::Value*
+Json::Value::find(const Json::Key& key) const
+{
+	const Json::Shared<Json::Object> *shared = boost::get<Json::Shared<Json::Object> >(&this->value);
+	if (NULL == shared) return NULL;
+
+	const Json::Object *obj = &shared->get();
+	Json::Object::const_iterator it = obj->find(key.name());
+	return (it == obj->end()) ? NULL : &it->second;
+}
+
+const Json::Value&
 Json::Value::operator[](const char* key) const throw (Json::Exception)
 {
-	Json::Object obj          = this->asObject();
-	Json::Object::iterator it = obj.find(key);
+	const Json::Object& obj = this->asObject();
+	Json::Object::const_iterator it = obj.find(Json::StringView(key));
 
 	if (it == obj.end()) {
 		throw Json::Exception("Key does not exist in object.");
@@ -121,38 +431,225 @@ Json::Value::operator[](const char* key) const throw (Json::Exception)
 	return it->second;
 }
 
-Json::Value
+const Json::Value&
 Json::Value::operator[](int key) const throw (Json::Exception)
 {
-	try {
-		return this->asArray().at(key);
-	} catch (std::out_of_range) {
+	const Json::Array& arr = this->asArray();
+	if (key < 0 || static_cast<size_t>(key) >= arr.size()) {
+		throw Json::Exception("Out of array bounds.");
+	}
+
+	return arr[key];
+}
+
+const Json::Value&
+Json::Value::operator[](const Json::Key& key) const throw (Json::Exception)
+{
+	const Json::Object& obj = this->asObject();
+	Json::Object::const_iterator it = obj.find(key.name());
+
+	if (it == obj.end()) {
+		throw Json::Exception("Key does not exist in object.");
+	}
+
+	return it->second;
+}
+
+Json::Value&
+Json::Value::operator[](const Json::Key& key) throw (Json::Exception)
+{
+	Json::Object& obj = this->storage<Json::Object>().modify();
+	Json::Object::iterator it = obj.find(key.name());
+
+	if (it == obj.end()) {
+		throw Json::Exception("Key does not exist in object.");
+	}
+
+	return it->second;
+}
+
+Json::Value&
+Json::Value::operator[](const char* key) throw (Json::Exception)
+{
+	Json::Object& obj = this->storage<Json::Object>().modify();
+	Json::Object::iterator it = obj.find(Json::StringView(key));
+
+	if (it == obj.end()) {
+		throw Json::Exception("Key does not exist in object.");
+	}
+
+	return it->second;
+}
+
+Json::Value&
+Json::Value::operator[](int key) throw (Json::Exception)
+{
+	Json::Array& arr = this->storage<Json::Array>().modify();
+	if (key < 0 || static_cast<size_t>(key) >= arr.size()) {
 		throw Json::Exception("Out of array bounds.");
 	}
+
+	return arr[key];
 }
 
-Json::Array
+Json::Value&
+Json::Value::set(Json::StringView key, Json::Value v) throw (Json::Exception)
+{
+	if (JVNULL == this->type) {
+		this->value = Json::Shared<Json::Object>();
+		this->type  = JVOBJECT;
+	}
+
+	/* Like erase(), push_back() and insert(), this ends any borrow from asObject(), see Json::Shared::settle(). */
+	Json::Shared<Json::Object>& shared = this->storage<Json::Object>();
+	shared.settle();
+	Json::Object& obj = shared.modify();
+	Json::Object::iterator it = obj.lower_bound(key);
+
+	if (it != obj.end() && it->first == key) {
+		it->second = std::move(v);
+	} else {
+		it = obj.emplace_hint(it, key.to_string(), std::move(v));
+	}
+
+	return it->second;
+}
+
+bool
+Json::Value::erase(Json::StringView key) throw (Json::Exception)
+{
+	Json::Shared<Json::Object>& shared = this->storage<Json::Object>();
+	shared.settle();
+	Json::Object& obj = shared.modify();
+	Json::Object::iterator it = obj.find(key);
+
+	if (it == obj.end()) return false;
+
+	obj.erase(it);
+	return true;
+}
+
+void
+Json::Value::erase(int key) throw (Json::Exception)
+{
+	Json::Shared<Json::Array>& shared = this->storage<Json::Array>();
+	shared.settle();
+	Json::Array& arr = shared.modify();
+	if (key < 0 || static_cast<size_t>(key) >= arr.size()) {
+		throw Json::Exception("Out of array bounds.");
+	}
+
+	arr.erase(arr.begin() + key);
+}
+
+Json::Value&
+Json::Value::push_back(Json::Value v) throw (Json::Exception)
+{
+	if (JVNULL == this->type) {
+		this->value = Json::Shared<Json::Array>();
+		this->type  = JVARRAY;
+	}
+
+	Json::Shared<Json::Array>& shared = this->storage<Json::Array>();
+	shared.settle();
+	Json::Array& arr = shared.modify();
+	arr.push_back(std::move(v));
+
+	return arr.back();
+}
+
+Json::Value&
+Json::Value::insert(int key, Json::Value v) throw (Json::Exception)
+{
+	Json::Shared<Json::Array>& shared = this->storage<Json::Array>();
+	shared.settle();
+	Json::Array& arr = shared.modify();
+	if (key < 0 || static_cast<size_t>(key) > arr.size()) {
+		throw Json::Exception("Out of array bounds.");
+	}
+
+	return *arr.insert(arr.begin() + key, std::move(v));
+}
+
+const Json::Array&
 Json::Value::asArray() const throw (Json::Exception)
 {
-	return this->get<Json::Array>();
+	return this->ref<Json::Array>();
+}
+
+Json::Array&
+Json::Value::asArray() throw (Json::Exception)
+{
+	return this->ref<Json::Array>();
 }
 
-Json::Object
+const Json::Object&
 Json::Value::asObject() const throw (Json::Exception)
 {
-	return this->get<Json::Object>();
+	return this->ref<Json::Object>();
+}
+
+Json::Object&
+Json::Value::asObject() throw (Json::Exception)
+{
+	return this->ref<Json::Object>();
 }
 
 Json::Int
 Json::Value::asInt() const throw (Json::Exception)
 {
-	try {
-		return this->get<int>();
-	} catch (Json::Exception) {}
+	if (const Json::Int *i = boost::get<Json::Int>(&this->value)) return *i;
+	if (const Json::Number *n = boost::get<Json::Number>(&this->value)) {
+		if (*n == std::trunc(*n)) {
+			if (std::numeric_limits<Json::Int>::min() <= *n && *n <= std::numeric_limits<Json::Int>::max()) {
+				return static_cast<Json::Int>(*n);
+			}
+			throw Json::Exception("Number does not fit in Json::Int.");
+		}
+	}
 
-	try {
-		return this->get<double>();
-	} catch (Json::Exception) {}
+	if (this->isInteger()) {
+		throw Json::Exception("Integer value does not fit in Json::Int.");
+	}
+	throw Json::Exception("Could not represent value as an integer.");
+}
+
+Json::Int64
+Json::Value::asInt64() const throw (Json::Exception)
+{
+	if (const Json::Int *i = boost::get<Json::Int>(&this->value)) return *i;
+	if (const Json::Int64 *i = boost::get<Json::Int64>(&this->value)) return *i;
+	if (const Json::Number *n = boost::get<Json::Number>(&this->value)) {
+		/* -2^63 and 2^63, which are exact as doubles. */
+		if (*n == std::trunc(*n) && -9223372036854775808.0 <= *n && *n < 9223372036854775808.0) {
+			return static_cast<Json::Int64>(*n);
+		}
+	}
+
+	if (this->isInteger()) {
+		throw Json::Exception("Integer value does not fit in Json::Int64.");
+	}
+	throw Json::Exception("Could not represent value as an integer.");
+}
+
+Json::UInt64
+Json::Value::asUInt64() const throw (Json::Exception)
+{
+	if (const Json::UInt64 *u = boost::get<Json::UInt64>(&this->value)) return *u;
+
+	if (this->isInteger()) {
+		Json::Int64 i = this->asInt64();
+		if (i < 0) throw Json::Exception("Negative integer value does not fit in Json::UInt64.");
+		return i;
+	}
+
+	const Json::Number *n = boost::get<Json::Number>(&this->value);
+	if (NULL != n && *n == std::trunc(*n)) {
+		if (*n < 0) throw Json::Exception("Negative number does not fit in Json::UInt64.");
+		/* 2^64, which is exact as a double. */
+		if (*n < 18446744073709551616.0) return static_cast<Json::UInt64>(*n);
+		throw Json::Exception("Number does not fit in Json::UInt64.");
+	}
 
 	throw Json::Exception("Could not represent value as an integer.");
 }
@@ -160,13 +657,10 @@ Json::Value::asInt() const throw (Json::Exception)
 Json::Number
 Json::Value::asNumber() const throw (Json::Exception)
 {
-	try {
-		return this->get<double>();
-	} catch (Json::Exception) {}
-
-	try {
-		return this->get<int>();
-	} catch (Json::Exception) {}
+	if (const Json::Number *n = boost::get<Json::Number>(&this->value)) return *n;
+	if (const Json::Int *i = boost::get<Json::Int>(&this->value)) return *i;
+	if (const Json::Int64 *i = boost::get<Json::Int64>(&this->value)) return *i;
+	if (const Json::UInt64 *u = boost::get<Json::UInt64>(&this->value)) return *u;
 
 	throw Json::Exception("Could not represent value as a number.");
 }
@@ -177,10 +671,48 @@ Json::Value::asBool() const throw (Json::Exception)
 	return this->get<bool>();
 }
 
-Json::String
+const Json::String&
 Json::Value::asString() const throw (Json::Exception)
 {
-	return this->get<Json::String>();
+	return this->ref<Json::String>();
+}
+
+Json::StringView
+Json::Value::asStringView() const throw (Json::Exception)
+{
+	return Json::StringView(this->ref<Json::String>());
+}
+
+const Json::RawJson&
+Json::Value::asRawJson() const throw (Json::Exception)
+{
+	return this->ref<Json::RawJson>();
+}
+
+Json::Value::const_iterator
+Json::Value::begin() const throw (Json::Exception)
+{
+	return this->asArray().begin();
+}
+
+Json::Value::const_iterator
+Json::Value::end() const throw (Json::Exception)
+{
+	return this->asArray().end();
+}
+
+Json::Value::ElementRange
+Json::Value::elements() const throw (Json::Exception)
+{
+	const Json::Array& arr = this->asArray();
+	return ElementRange(arr.begin(), arr.end());
+}
+
+Json::Value::ItemRange
+Json::Value::items() const throw (Json::Exception)
+{
+	const Json::Object& obj = this->asObject();
+	return ItemRange(obj.begin(), obj.end());
 }
 
 bool
@@ -189,325 +721,496 @@ Json::Value::isNull() const
 	return JVNULL == this->type;
 }
 
+bool
+Json::Value::isInteger() const
+{
+	return this->value.type() == typeid(Json::Int) ||
+	       this->value.type() == typeid(Json::Int64) ||
+	       this->value.type() == typeid(Json::UInt64);
+}
+
 std::string
-Json::Value::minify(std::string json)
+Json::Value::minify(const std::string& json)
 {
 	std::string ret;
 	bool insignificant = true;
-	for (unsigned int i = 0; i < json.length(); ++i) {
-		if ('"' == json[i]) insignificant = !insignificant;
+	for (size_t i = 0; i < json.length(); ++i) {
+		if (!insignificant && '\\' == json[i] && i + 1 < json.length()) {
+			/* The escaped character neither ends the string nor is dropped. */
+			ret += json[i++];
+		} else if ('"' == json[i]) {
+			insignificant = !insignificant;
+		}
 		if (!(insignificant && isspace(json[i]))) ret += json[i];
 	}
 	return ret;
 }
 
+std::string
+Json::Value::strjson(strformat t) const
+{
+	std::string out;
+	this->strjson(out, t);
+	return out;
+}
+
 void
-Json::Value::unescape(std::string& str) const
+Json::Value::strjson(std::string& out, strformat t) const
 {
-	size_t pos = 0;
-	while (std::string::npos != (pos = str.find('\\', pos))) {
-		str.erase(pos, 1);
-		pos += 2;
-	}
+	StrjsonContext ctx(out, t);
+	this->strjson(ctx);
 }
 
 void
-Json::Value::escape(std::string& str, const char c) const
+Json::Value::strjson(StrjsonContext& ctx) const
 {
-	size_t pos = 0;
-	while (std::string::npos != (pos = str.find(c, pos))) {
-		str.insert(pos, "\\");
-		pos += 2;
+	switch (this->type) {
+		case JVOBJECT: this->strjsonObject(ctx);                     break;
+		case JVARRAY:  this->strjsonArray(ctx);                      break;
+		case JVNUMBER: this->strjsonNumber(ctx);                     break;
+		case JVSTRING: strjsonString(ctx.out, this->asStringView()); break;
+		case JVBOOL:   this->strjsonBool(ctx.out);                   break;
+		case JVNULL:   this->strjsonNull(ctx.out);                   break;
+		case JVRAW:    this->strjsonRaw(ctx);                        break;
+		default: throw Json::Exception("Type is unknown.");
 	}
 }
 
-std::string
-Json::Value::extractLiteral(std::string str, size_t pos = 0) throw (Json::Exception)
+void
+Json::Value::strjsonSeparator(StrjsonContext& ctx, bool first)
 {
-	size_t end = pos;
-	while(end < str.length()) {
-		if (!isalnum(str[end]) &&
-		    '.' != str[end] &&
-		    '-' != str[end]) break;
-		end++;
+	if (FORMAT_PRETTY != ctx.format) {
+		if (!first) ctx.out += ',';
+		return;
 	}
 
-	if (end == pos) throw Json::Exception("Literal did not start with alphanumeric.");
-
-	return str.substr(pos, end - pos);
+	if (!first) ctx.out += ",\n";
+	ctx.out.append(ctx.indent, '\t');
 }
 
-std::string
-Json::Value::extract(std::string str,
-                     size_t pos = 0,
-                     bool keep_delimiters = false) throw (Json::Exception)
+void
+Json::Value::strjsonOpen(StrjsonContext& ctx, char c)
 {
-	if (pos >= str.length()) return std::string();
+	ctx.out += c;
+	if (FORMAT_PRETTY == ctx.format) ctx.out += '\n';
+	ctx.indent++;
+}
 
-	bool instring = false;
-	char sdelim = str[pos], edelim;
-	switch (sdelim) {
-		case '{': edelim = '}'; break;
-		case '[': edelim = ']'; break;
-		case '"': edelim = '"'; instring = true; break;
-		default: return this->extractLiteral(str, pos);
+void
+Json::Value::strjsonClose(StrjsonContext& ctx, char c)
+{
+	ctx.indent--;
+	if (FORMAT_PRETTY == ctx.format) {
+		ctx.out += '\n';
+		ctx.out.append(ctx.indent, '\t');
 	}
+	ctx.out += c;
+}
 
-	size_t depth = 1;
-	size_t cpos  = pos + 1;
-	char current = 0, previous = 0;
-	std::stringstream ss(str);
-	ss.seekg(cpos);
-	do {
-		previous = current;
-		current  = ss.get();
-		if ('"' == current && previous != '\\') instring = !instring;
-		if (instring) continue;
+/*
+ * Output shorter than this is cheaper to write again than to keep.
+ * Output longer than this is mostly made of members which are kept
+ * themselves, so keeping it too would only double the memory used.
+ */
+static const size_t MEMO_MIN_SIZE = 64;
+static const size_t MEMO_MAX_SIZE = 1024 * 1024;
+
+/*
+ * The memo of 'shared' holding its output in 'format' at depth
+ * 'indent', or NULL. Pretty output depends on the depth it is
+ * written at; minified does not. Unless 'memoized', only the
+ * source a value was parsed from is used, and not the output
+ * kept by serializations which memoize.
+ */
+template <class T> static const typename Json::Shared<T>::Memo*
+recall(const Json::Shared<T>& shared, Json::strformat format, size_t indent, bool memoized)
+{
+	const typename Json::Shared<T>::Memo *memo = shared.memo(format);
+	if (NULL == memo || memo->key != (Json::FORMAT_PRETTY == format ? indent : 0)) return NULL;
+	if (!memoized && !memo->source) return NULL;
+	return memo;
+}
 
-		depth += (current == sdelim && sdelim   != edelim);
-		depth -= (current == edelim && previous != '\\');
-	} while (++cpos < str.length() && 0 != depth);
+template <class T> bool
+Json::Value::strjsonRecall(StrjsonContext& ctx, const Json::Shared<T>& shared)
+{
+	if (ctx.canonical) return false;
 
-	if (edelim != str[cpos - 1]) throw Json::Exception("Not enclosed.");
+	const typename Json::Shared<T>::Memo *memo = recall(shared, ctx.format, ctx.indent, ctx.memoize);
+	if (NULL == memo) return false;
 
-	return str.substr(pos + !keep_delimiters,
-	                  cpos - pos - 2*(!keep_delimiters));
+	ctx.out.append(memo->data, memo->length);
+	return true;
 }
 
-void
-Json::Value::formatStringForOutput(std::string& str) const
+template <class T> void
+Json::Value::strjsonMemoize(StrjsonContext& ctx, const Json::Shared<T>& shared, size_t start)
 {
-	this->escape(str, '\\');
-	this->escape(str, '"');
-	str.insert(0, "\"");
-	str.append("\"");
+	size_t length = ctx.out.length() - start;
+	if (!ctx.memoize || length < MEMO_MIN_SIZE || length >= MEMO_MAX_SIZE) return;
+
+	shared.memoize(ctx.format, FORMAT_PRETTY == ctx.format ? ctx.indent : 0, ctx.out.substr(start));
 }
 
-std::string
-Json::Value::strjson(strformat t) const
+bool
+Json::Value::strjsonKept(StrjsonContext& ctx) const
 {
-	static size_t indent = -1;
-	indent++;
-	std::string strjson;
-	switch (this->type) {
-		case JVOBJECT: this->strjsonObject(strjson, indent); break;
-		case JVARRAY:  this->strjsonArray(strjson, indent);  break;
-		case JVNUMBER: this->strjsonNumber(strjson);         break;
-		case JVSTRING: this->strjsonString(strjson);         break;
-		case JVBOOL:   this->strjsonBool(strjson);           break;
-		case JVNULL:   this->strjsonNull(strjson);           break;
-		default: throw Json::Exception("Type is unknown.");
-	}
-	indent--;
+	const Json::Shared<Json::Object> *obj = boost::get<Json::Shared<Json::Object> >(&this->value);
+	if (NULL != obj) return strjsonRecall(ctx, *obj);
 
-	switch (t) {
-		case FORMAT_PRETTY:                                    break;
-		case FORMAT_MINIFIED: strjson = this->minify(strjson); break;
-	}
+	const Json::Shared<Json::Array> *arr = boost::get<Json::Shared<Json::Array> >(&this->value);
+	if (NULL != arr) return strjsonRecall(ctx, *arr);
+
+	const Json::Shared<Json::PackedArray<double> > *doubles =
+		boost::get<Json::Shared<Json::PackedArray<double> > >(&this->value);
+	if (NULL != doubles) return strjsonRecall(ctx, *doubles);
 
-	return strjson;
+	const Json::Shared<Json::PackedArray<int64_t> > *ints =
+		boost::get<Json::Shared<Json::PackedArray<int64_t> > >(&this->value);
+	if (NULL != ints) return strjsonRecall(ctx, *ints);
+
+	return false;
 }
 
 void
-Json::Value::strjsonObject(std::string& strjson, size_t indent) const
+Json::Value::keepSource(Json::StringView raw, const std::shared_ptr<const std::string>& source)
 {
-	Json::Object obj = this->asObject();
-	typedef Json::Object::const_iterator objit;
+	/* Like memoized output, short JSON is cheaper to write again than to keep. */
+	if (raw.length() < MEMO_MIN_SIZE) return;
+
+	const Json::Shared<Json::Object> *obj = boost::get<Json::Shared<Json::Object> >(&this->value);
+	const Json::Shared<Json::Array> *arr = boost::get<Json::Shared<Json::Array> >(&this->value);
+	const Json::Shared<Json::PackedArray<double> > *doubles =
+		boost::get<Json::Shared<Json::PackedArray<double> > >(&this->value);
+	const Json::Shared<Json::PackedArray<int64_t> > *ints =
+		boost::get<Json::Shared<Json::PackedArray<int64_t> > >(&this->value);
+
+	if (NULL != obj)     obj->memoize(FORMAT_MINIFIED, 0, source, raw.data(), raw.length());
+	if (NULL != arr)     arr->memoize(FORMAT_MINIFIED, 0, source, raw.data(), raw.length());
+	if (NULL != doubles) doubles->memoize(FORMAT_MINIFIED, 0, source, raw.data(), raw.length());
+	if (NULL != ints)    ints->memoize(FORMAT_MINIFIED, 0, source, raw.data(), raw.length());
+}
+
+void
+Json::Value::strjsonObject(StrjsonContext& ctx) const
+{
+	const Json::Shared<Json::Object>& shared = boost::get<Json::Shared<Json::Object> >(this->value);
+	if (strjsonRecall(ctx, shared)) return;
 
-	strjson += "{\n";
+	const Json::Object& obj = shared.get();
+	typedef Json::Object::const_iterator objit;
 
-	std::string sep;
+	size_t start = ctx.out.length();
+	strjsonOpen(ctx, '{');
 	for (objit it = obj.begin(); it != obj.end(); ++it) {
-		strjson += sep;
-		std::string key = it->first;
-		this->formatStringForOutput(key);
-		std::string value = it->second.strjson();
-
-		strjson.append(indent + 1, '\t');
-		strjson += key + " : " + value;
-		sep = ",\n";
+		strjsonSeparator(ctx, it == obj.begin());
+		strjsonString(ctx.out, it->first);
+		ctx.out += ctx.colon;
+		it->second.strjson(ctx);
 	}
+	strjsonClose(ctx, '}');
+	strjsonMemoize(ctx, shared, start);
+}
 
-	strjson += "\n";
-	strjson.append(indent, '\t');
-	strjson += "}";
+template <class T> void
+Json::Value::strjsonPacked(StrjsonContext& ctx, const Json::Shared<Json::PackedArray<T> >& packed)
+{
+	if (strjsonRecall(ctx, packed)) return;
+
+	const std::vector<T>& values = packed.get().values;
+
+	size_t start = ctx.out.length();
+	strjsonOpen(ctx, '[');
+	for (size_t i = 0; i < values.size(); ++i) {
+		strjsonSeparator(ctx, 0 == i);
+		if (ctx.canonical) {
+			strjsonCanonical(ctx.out, values[i]);
+		} else {
+			strjsonNumber(ctx.out, values[i]);
+		}
+	}
+	strjsonClose(ctx, ']');
+	strjsonMemoize(ctx, packed, start);
 }
 
 void
-Json::Value::strjsonArray(std::string& strjson, size_t indent) const
+Json::Value::strjsonArray(StrjsonContext& ctx) const
 {
-	Json::Array arr = this->asArray();
-	typedef Json::Array::const_iterator arrit;
+	const Json::Shared<Json::PackedArray<double> > *doubles =
+		boost::get<Json::Shared<Json::PackedArray<double> > >(&this->value);
+	if (NULL != doubles) return strjsonPacked(ctx, *doubles);
 
-	strjson += "[\n";
+	const Json::Shared<Json::PackedArray<int64_t> > *ints =
+		boost::get<Json::Shared<Json::PackedArray<int64_t> > >(&this->value);
+	if (NULL != ints) return strjsonPacked(ctx, *ints);
 
-	std::string sep;
-	for (arrit it = arr.begin(); it != arr.end(); it++) {
-		strjson += sep;
-		strjson.append(indent + 1, '\t');
-		strjson += it->strjson();
-		sep = ",\n";
-	}
+	const Json::Shared<Json::Array>& shared = boost::get<Json::Shared<Json::Array> >(this->value);
+	if (strjsonRecall(ctx, shared)) return;
+
+	const Json::Array& arr = shared.get();
+	typedef Json::Array::const_iterator arrit;
 
-	strjson += "\n";
-	strjson.append(indent, '\t');
-	strjson += "]";
+	size_t start = ctx.out.length();
+	strjsonOpen(ctx, '[');
+	for (arrit it = arr.begin(); it != arr.end(); ++it) {
+		strjsonSeparator(ctx, it == arr.begin());
+		it->strjson(ctx);
+	}
+	strjsonClose(ctx, ']');
+	strjsonMemoize(ctx, shared, start);
 }
 
 void
-Json::Value::strjsonNumber(std::string& strjson) const
+Json::Value::strjsonNumber(StrjsonContext& ctx) const
 {
-	if (this->value.type() == typeid(Json::Int)) {
-		strjson = boost::lexical_cast<std::string>(this->asInt());
+	if (this->value.type() == typeid(Json::UInt64)) {
+		strjsonNumber(ctx.out, this->asUInt64());
+	} else if (this->isInteger()) {
+		strjsonNumber(ctx.out, this->asInt64());
+	} else if (ctx.canonical) {
+		strjsonCanonical(ctx.out, this->asNumber());
 	} else {
-		strjson = boost::lexical_cast<std::string>(this->asNumber());
+		strjsonNumber(ctx.out, this->asNumber());
 	}
 }
 
 void
-Json::Value::strjsonString(std::string& strjson) const
+Json::Value::strjsonNumber(std::string& out, Json::Int64 i)
 {
-	strjson = this->asString();
-	this->formatStringForOutput(strjson);
+	char buf[Json::NUMBER_BUFFER_SIZE];
+	out.append(buf, Json::formatInteger(buf, i));
 }
 
 void
-Json::Value::strjsonBool(std::string& strjson) const
+Json::Value::strjsonNumber(std::string& out, Json::UInt64 i)
 {
-	strjson = (this->asBool() ? "true" : "false");
+	char buf[Json::NUMBER_BUFFER_SIZE];
+	out.append(buf, Json::formatInteger(buf, i));
 }
 
 void
-Json::Value::strjsonNull(std::string& strjson) const
+Json::Value::strjsonNumber(std::string& out, Json::Number n)
 {
-	strjson = "null";
+	char buf[Json::NUMBER_BUFFER_SIZE];
+	out.append(buf, Json::formatNumber(buf, n));
 }
 
-void
-Json::Value::parse(std::string json) throw (Json::Exception)
+static inline bool
+needsEscape(unsigned char c)
 {
-	this->type = ValueType(json[0]);
-	switch (this->type) {
-		case JVOBJECT:
-			this->parseObject(json);
-			break;
-		case JVARRAY:
-			this->parseArray(json);
-			break;
-		case JVNUMBER:
-			this->parseNumber(json);
-			break;
-		case JVSTRING:
-			this->parseString(json);
-			break;
-		case JVBOOL:
-			this->parseBool(json);
-			break;
-		case JVNULL:
-			this->parseNull(json);
-			break;
-	}
+	return c < 0x20 || '"' == c || '\\' == c;
 }
 
-void
-Json::Value::parseString(std::string json) throw (Json::Exception)
+/*
+ * Finds the first character in [c, end) which needs escaping, or end.
+ * Where SSE2 is available 16 characters are tested at a time.
+ */
+static const char*
+findEscape(const char *c, const char *end)
 {
-	std::string str = this->extract(json);
-	this->unescape(str);
+#ifdef __SSE2__
+	const __m128i quote     = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i control   = _mm_set1_epi8(0x1F);
 
-	this->value = str;
-	this->type  = JVSTRING;
-}
+	for (; end - c >= 16; c += 16) {
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
 
-void
-Json::Value::parseNumber(std::string json) throw (Json::Exception)
-{
-	this->type = JVNUMBER;
+		/* max(c, 0x1F) == 0x1F holds for the (unsigned) bytes below 0x20. */
+		__m128i hits = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control);
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, quote));
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, backslash));
 
-	try {
-		this->value = boost::lexical_cast<Json::Int>(json);
-		return;
-	} catch (boost::bad_lexical_cast) {}
+		const int mask = _mm_movemask_epi8(hits);
+		if (0 != mask) return c + __builtin_ctz(mask);
+	}
+#endif
 
-	try {
-		this->value = boost::lexical_cast<Json::Number>(json);
-		return;
-	} catch (boost::bad_lexical_cast) {}
+	for (; c != end; ++c) {
+		if (needsEscape(*c)) return c;
+	}
+	return end;
+}
 
-	throw Json::Exception("Number value invalid.");
+static void
+appendEscape(std::string& out, unsigned char c)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	switch (c) {
+		case '"':  out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\b': out += "\\b"; break;
+		case '\f': out += "\\f"; break;
+		case '\n': out += "\\n"; break;
+		case '\r': out += "\\r"; break;
+		case '\t': out += "\\t"; break;
+		default: {
+			const char u[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+			out.append(u, sizeof(u));
+			break;
+		}
+	}
 }
 
 void
-Json::Value::parseBool(std::string json) throw (Json::Exception)
+Json::Value::strjsonString(std::string& out, Json::StringView str)
 {
-	if ("true" == json) {
-		this->value = true;
-	} else if ("false" == json) {
-		this->value = false;
-	} else {
-		throw Json::Exception("Boolean value invalid.");
+	out += '"';
+
+	/* Copy the runs between characters which need escaping in one go. */
+	const char *run = str.data(), *end = str.data() + str.length();
+	for (const char *c = findEscape(run, end); c != end; c = findEscape(run, end)) {
+		out.append(run, c - run);
+		appendEscape(out, *c);
+		run = c + 1;
 	}
+	out.append(run, end - run);
+
+	out += '"';
 }
 
-void
-Json::Value::parseNull(std::string json) throw (Json::Exception)
+size_t
+Json::Value::strjsonStringSize(Json::StringView str)
 {
-	if ("null" != json) {
-		throw Json::Exception("Null value invalid.");
+	size_t size = 2 + str.length();
+
+	const char *end = str.data() + str.length();
+	for (const char *c = findEscape(str.data(), end); c != end; c = findEscape(c + 1, end)) {
+		switch (*c) {
+			case '"': case '\\': case '\b': case '\f': case '\n': case '\r': case '\t':
+				size += 1;
+				break;
+			default:
+				/* \u00XX */
+				size += 5;
+				break;
+		}
 	}
+
+	return size;
 }
 
-void
-Json::Value::parseObject(std::string json) throw (Json::Exception)
+size_t
+Json::Value::strjsonContainerSize(strformat t, size_t indent, size_t members)
 {
-	std::string object = this->extract(json);
+	size_t separators = members > 0 ? members - 1 : 0;
+	if (FORMAT_PRETTY != t) return 2 + separators;
 
-	Json::Object o;
-	unsigned int keystart = 0;
-	while(keystart < object.length()) {
-		std::string key = this->extract(object, keystart);
-		size_t klength  = key.length();
-		this->unescape(key);
+	/* "{\n", ",\n" and the indentation before each member, "\n", the indentation and "}". */
+	return 2 + 2 * separators + members * (indent + 1) + 1 + indent + 1;
+}
 
-		char keyvalsep = object[keystart + klength + 2];
-		if (keyvalsep != ':') {
-			throw Json::Exception("Invalid key-value separator.");
-		}
+template <class T> static size_t
+numberSize(T n)
+{
+	char buf[Json::NUMBER_BUFFER_SIZE];
+	return Json::formatInteger(buf, n);
+}
 
-		std::string value = this->extract(object, keystart + klength + 3, true);
-		size_t vlength    = value.length();
+static size_t
+numberSize(double n)
+{
+	char buf[Json::NUMBER_BUFFER_SIZE];
+	return Json::formatNumber(buf, n);
+}
 
-		o[key] = Value(value, Value::MODE_PARSE);
+template <class T> static size_t
+packedSize(const std::vector<T>& values)
+{
+	size_t size = 0;
+	for (size_t i = 0; i < values.size(); ++i) size += numberSize(values[i]);
+	return size;
+}
 
-		keystart += klength + vlength + 4;
+size_t
+Json::Value::strjsonSize(strformat t, size_t indent) const
+{
+	switch (this->type) {
+		case JVOBJECT: {
+			const Json::Shared<Json::Object>& shared = boost::get<Json::Shared<Json::Object> >(this->value);
+			const Json::Shared<Json::Object>::Memo *memo = recall(shared, t, indent, false);
+			if (NULL != memo) return memo->length;
+
+			const Json::Object& obj = shared.get();
+			const size_t colon = (FORMAT_PRETTY == t ? 3 : 1);
+
+			size_t size = strjsonContainerSize(t, indent, obj.size());
+			for (Json::Object::const_iterator it = obj.begin(); it != obj.end(); ++it) {
+				size += strjsonStringSize(it->first) + colon + it->second.strjsonSize(t, indent + 1);
+			}
+			return size;
+		}
 
-		char sep = object[keystart - 1];
-		if (sep != ',' && keystart < object.length()) {
-			throw Json::Exception("Value separator in object invalid.");
+		case JVARRAY: {
+			const Json::Shared<Json::PackedArray<double> > *doubles =
+				boost::get<Json::Shared<Json::PackedArray<double> > >(&this->value);
+			if (NULL != doubles) {
+				const Json::Shared<Json::PackedArray<double> >::Memo *memo = recall(*doubles, t, indent, false);
+				if (NULL != memo) return memo->length;
+
+				const std::vector<double>& values = doubles->get().values;
+				return strjsonContainerSize(t, indent, values.size()) + packedSize(values);
+			}
+
+			const Json::Shared<Json::PackedArray<int64_t> > *ints =
+				boost::get<Json::Shared<Json::PackedArray<int64_t> > >(&this->value);
+			if (NULL != ints) {
+				const Json::Shared<Json::PackedArray<int64_t> >::Memo *memo = recall(*ints, t, indent, false);
+				if (NULL != memo) return memo->length;
+
+				const std::vector<int64_t>& values = ints->get().values;
+				return strjsonContainerSize(t, indent, values.size()) + packedSize(values);
+			}
+
+			const Json::Shared<Json::Array>& shared = boost::get<Json::Shared<Json::Array> >(this->value);
+			const Json::Shared<Json::Array>::Memo *memo = recall(shared, t, indent, false);
+			if (NULL != memo) return memo->length;
+
+			const Json::Array& arr = shared.get();
+			size_t size = strjsonContainerSize(t, indent, arr.size());
+			for (Json::Array::const_iterator it = arr.begin(); it != arr.end(); ++it) {
+				size += it->strjsonSize(t, indent + 1);
+			}
+			return size;
 		}
-	}
 
-	this->value = o;
+		case JVNUMBER:
+			if (this->value.type() == typeid(Json::UInt64)) return numberSize(this->asUInt64());
+			if (this->isInteger()) return numberSize(this->asInt64());
+			return numberSize(this->asNumber());
+
+		case JVSTRING: return strjsonStringSize(this->asStringView());
+		case JVBOOL:   return this->asBool() ? 4 : 5;
+		case JVNULL:   return 4;
+		case JVRAW:    return this->asRawJson().json().length();
+		default: throw Json::Exception("Type is unknown.");
+	}
 }
 
 void
-Json::Value::parseArray(std::string json) throw (Json::Exception)
+Json::Value::strjsonBool(std::string& out) const
 {
-	std::string array = this->extract(json);
-
-	Json::Array a;
-	unsigned int valstart = 0;
-	while (valstart < array.length()) {
-		std::string value = this->extract(array, valstart, true);
-		a.push_back(Value(value, Value::MODE_PARSE));
+	out += (this->asBool() ? "true" : "false");
+}
 
-		valstart += value.length() + 1;
+void
+Json::Value::strjsonNull(std::string& out) const
+{
+	out += "null";
+}
 
-		char sep = array[valstart - 1];
-		if (sep != ',' && valstart < array.length()) {
-			throw Json::Exception("Value separator in array invalid.");
-		}
+void
+Json::Value::strjsonRaw(StrjsonContext& ctx) const
+{
+	Json::StringView json = this->asRawJson().json();
+	if (!ctx.canonical) {
+		ctx.out.append(json.data(), json.length());
+		return;
 	}
 
-	this->value = a;
+	/* Canonical output only depends on what the fragment holds. */
+	Json::Reader r(json);
+	r.tree().strjson(ctx);
+	r.next();
 }
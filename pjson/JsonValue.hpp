@@ -3,12 +3,18 @@
 
 #include <boost/variant.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/utility/string_view.hpp>
 #include <string>
 #include <map>
 #include <vector>
+#include <iterator>
+#include <atomic>
 #include <stdexcept>
+#include <stdint.h>
 
 #include "JsonException.hpp"
+#include "JsonShared.hpp"
+#include "JsonKey.hpp"
 
 /// Default namespace for the <em>pjson</em> library.
 /**
@@ -18,6 +24,9 @@
 namespace Json {
 	class Value;
 	class Builder;
+	template <class T> class PackedArray;
+	template <class T, class Enable = void> struct Serializer;
+	class Output;
 
 	/**
 	 * The format with which a json string can be printed
@@ -35,6 +44,41 @@ namespace Json {
 		FORMAT_MINIFIED
 	};
 
+	/**
+	 * How the string a value is serialized into is sized.
+	 */
+	enum strreserve {
+		/**
+		 * The string grows as the value is written.
+		 */
+		RESERVE_GROW,
+
+		/**
+		 * The exact size of the output is computed first, see
+		 * Json::serializedSize, and reserved at once. The string is
+		 * never reallocated while the value is written, at the cost
+		 * of one more pass over the value.
+		 */
+		RESERVE_EXACT
+	};
+
+	/**
+	 * What a parsed value keeps of the JSON it was parsed from.
+	 */
+	enum strsource {
+		/**
+		 * Nothing; the value is serialized from its contents.
+		 */
+		SOURCE_DISCARD,
+
+		/**
+		 * Objects and Arrays keep the bytes they were parsed from, and
+		 * write them as they are when serialized in minified format,
+		 * until they are modified.
+		 */
+		SOURCE_KEEP
+	};
+
 	/**
 	 * The available JSON types.
 	 */
@@ -50,7 +94,9 @@ namespace Json {
 		/** Bool type (true, false) */
 		JVBOOL,
 		/** Null type (null) */
-		JVNULL
+		JVNULL,
+		/** JSON which is serialized already, see Json::RawJson */
+		JVRAW
 	};
 
 	/**
@@ -63,6 +109,11 @@ namespace Json {
 	 */
 	typedef const char* CString;
 
+	/**
+	 * A non-owning view of a JSON string.
+	 */
+	typedef boost::string_view StringView;
+
 	/**
 	 * A representation of a JSON number.
 	 */
@@ -74,6 +125,18 @@ namespace Json {
 	 */
 	typedef int Int;
 
+	/**
+	 * A 64-bit integer. Integers which do not fit in Json::Int
+	 * are held as Int64, so they keep their full precision.
+	 */
+	typedef int64_t Int64;
+
+	/**
+	 * An unsigned 64-bit integer. Only used for integers
+	 * which are too large for Json::Int64.
+	 */
+	typedef uint64_t UInt64;
+
 	/**
 	 * A representation of a JSON boolean; true or false.
 	 */
@@ -90,14 +153,101 @@ namespace Json {
 
 	/**
 	 * A representation of a JSON object; key, value pairs.
+	 * The transparent comparator allows members to be looked up
+	 * by Json::StringView or const char* without creating a std::string.
 	 */
-	typedef std::map<std::string, Json::Value> Object;
+	typedef std::map<std::string, Json::Value, std::less<> > Object;
 
 	/**
 	 * A representation of a JSON array; consecutive values.
 	 */
 	typedef std::vector<Json::Value> Array;
 
+	/// A pair of iterators usable in a range based for loop.
+	/**
+	 * Returned by Json::Value::elements() and Json::Value::items().
+	 * The range refers directly to the members of the Value it was
+	 * obtained from; nothing is copied.
+	 *
+	 * @tparam Iterator The iterator type of the range.
+	 */
+	template <class Iterator>
+	class Range
+	{
+		private:
+			Iterator first;
+			Iterator last;
+
+		public:
+			Range(Iterator first, Iterator last) : first(first), last(last) {}
+
+			Iterator begin() const { return this->first; }
+			Iterator end() const   { return this->last; }
+
+			/**
+			 * The number of members in the range.
+			 */
+			size_t size() const { return std::distance(this->first, this->last); }
+
+			/**
+			 * Tells whether there are no members in the range.
+			 */
+			bool empty() const { return this->first == this->last; }
+	};
+
+	/**
+	 * Contiguous doubles of a packed Array.
+	 * @see Json::Value::asDoubleSpan()
+	 */
+	typedef Range<const double*> DoubleSpan;
+
+	/**
+	 * Contiguous integers of a packed Array.
+	 * @see Json::Value::asIntSpan()
+	 */
+	typedef Range<const Json::Int64*> IntSpan;
+
+	/// A fragment of JSON which is serialized already.
+	/**
+	 * A Json::Value holding a RawJson writes the fragment as it is
+	 * wherever it is serialized; it is neither parsed nor encoded again.
+	 * Copies share the fragment, so a cached document can be part of
+	 * any number of responses without being copied:
+	 * @code
+	 * Json::RawJson cached(cache.get(key));
+	 * Json::Value response = Json::Builder::create(Json::value_t(Json::Object()));
+	 * response.set("meta", meta);
+	 * response.set("data", Json::Builder::create(cached));
+	 * @endcode
+	 *
+	 * @note The fragment is not checked; it must be one complete JSON
+	 *       value. It is written the same in every format, so pretty
+	 *       output is only indented around it.
+	 */
+	class RawJson
+	{
+		public:
+			/**
+			 * Holds 'json', which is taken over.
+			 */
+			explicit RawJson(std::string json)
+				: data(std::make_shared<const std::string>(std::move(json))) {}
+
+			/**
+			 * Shares 'json', which must not be NULL.
+			 */
+			explicit RawJson(std::shared_ptr<const std::string> json)
+				: data(std::move(json)) {}
+
+			/**
+			 * The fragment.
+			 */
+			Json::StringView json() const { return *this->data; }
+
+		private:
+			std::shared_ptr<const std::string> data;
+	};
+
 	/**
 	 * Storage of a JSON value. It can be either of the
 	 * types defined in the variant.
@@ -106,10 +256,13 @@ namespace Json {
 	                       Json::CString,
 	                       Json::Number,
 	                       Json::Int,
+	                       Json::Int64,
+	                       Json::UInt64,
 	                       Json::Bool,
 	                       Json::NullValue,
 	                       boost::recursive_wrapper<Json::Object>,
-	                       boost::recursive_wrapper<Json::Array> > value_t;
+	                       boost::recursive_wrapper<Json::Array>,
+	                       Json::RawJson> value_t;
 
 	/// The main class representing a JSON value.
 	/**
@@ -151,16 +304,36 @@ namespace Json {
 	 * }
 	 * @endcode
 	 *
+	 * Strings, Objects and Arrays are shared between copies of a Value
+	 * (see Json::Shared), so copying a Value is cheap regardless of its size.
+	 * A shared structure is copied first when it is modified through one of
+	 * the copies. Once asObject(), asArray() or asString() has returned a
+	 * modifiable reference into a structure it is not shared, so writing
+	 * through the reference never modifies a copy, until the structure is
+	 * next modified through set(), erase(), push_back() or insert(). Those
+	 * end the borrow and share the structure again; references taken
+	 * before must not be written through after that. The references
+	 * operator[], set(), push_back() and insert() return are meant for
+	 * immediate use, and never keep a structure from being shared.
+	 *
 	 * @see value_t
 	 */
 	class Value
 	{
 		friend class Builder;
-		friend Json::Value deserialize(std::string);
-		friend Json::Value deserialize(const char*);
-		template <class T> friend std::string serialize(T, strformat) throw (Json::Exception);
-		friend std::string serialize(Json::Value);
-		friend class std::map<std::string, Value>;
+		friend class Writer;
+		friend class Output;
+		friend class ParallelWriter;
+		friend class TreeBuilder;
+		friend class Comparison;
+		friend class CborWriter;
+		template <class T> friend std::string serialize(const T&, strformat) throw (Json::Exception);
+		friend std::string serialize(const Json::Value&, strformat) throw (Json::Exception);
+		friend void serialize(const Json::Value&, std::string&, strformat) throw (Json::Exception);
+		friend size_t serializedSize(const Json::Value&, strformat) throw (Json::Exception);
+		friend void serializeMemoized(const Json::Value&, std::string&, strformat) throw (Json::Exception);
+		friend void serializeCanonical(const Json::Value&, std::string&) throw (Json::Exception);
+		friend class std::map<std::string, Value, std::less<> >;
 
 		public:
 
@@ -215,6 +388,40 @@ namespace Json {
 			template <class T> T
 			get() const throw (Json::Exception);
 
+			/**
+			 * Looks up the value defined by 'key' in the Object
+			 * this value represents. Nothing is copied or allocated.
+			 *
+			 * @param key The key to look for.
+			 * @returns A pointer to the value identified by key, or NULL
+			 *          if this is not an Object or the key does not exist.
+			 */
+			const Value*
+			find(Json::StringView key) const;
+
+			/**
+			 * Looks up the value at index 'key' in the Array
+			 * this value represents.
+			 *
+			 * @param key The index to look for.
+			 * @returns A pointer to the value at index key, or NULL
+			 *          if this is not an Array or the index is out of bounds.
+			 */
+			const Value*
+			find(int key) const;
+
+			/**
+			 * Looks up the value defined by a precomputed key in the Object
+			 * this value represents.
+			 *
+			 * @param key The key to look for.
+			 * @returns A pointer to the value identified by key, or NULL
+			 *          if this is not an Object or the key does not exist.
+			 * @see Json::Key
+			 */
+			const Value*
+			find(const Json::Key& key) const;
+
 			/**
 			 * Fetches the value defined by 'key' in the Object
 			 * this value represents.
@@ -225,7 +432,7 @@ namespace Json {
 			 * @throws Json::Exception If the string is not a key in the object.
 			 * @returns The value identified by key.
 			 */
-			Value
+			const Value&
 			operator[](const char* key) const throw (Json::Exception);
 
 			/**
@@ -241,9 +448,134 @@ namespace Json {
 			 * @throws Json::Exception If the index is outside of the Array bounds.
 			 * @returns The value identified by key.
 			 */
-			Value
+			const Value&
 			operator[](int key) const throw (Json::Exception);
 
+			/**
+			 * Fetches the value defined by a precomputed key in the Object
+			 * this value represents.
+			 *
+			 * @param key The key to use to retrieve the value.
+			 * @throws Json::Exception If this is not an Object or the key
+			 *                         does not exist in it.
+			 * @returns The value identified by key.
+			 * @see Json::Key
+			 */
+			const Value&
+			operator[](const Json::Key& key) const throw (Json::Exception);
+
+			/**
+			 * Fetches a modifiable reference to the value defined by 'key'
+			 * in the Object this value represents. Unlike std::map, a
+			 * missing key is not inserted; use set() for that.
+			 *
+			 * The reference is meant for immediate use, e.g. to read or
+			 * assign the value, or to modify it through set(); it must not
+			 * be written through once this value has been copied, hashed
+			 * or serialized with Json::serializeMemoized since.
+			 *
+			 * @note Prefer the const overload when only reading, since this
+			 *       one copies the Object first if it is shared with another
+			 *       Value, and drops what is kept for it (see hash()).
+			 *
+			 * @param key The key to use to retrieve the value.
+			 * @throws Json::Exception If the string is not a key in the object.
+			 * @returns The value identified by key.
+			 */
+			Value&
+			operator[](const char* key) throw (Json::Exception);
+
+			/**
+			 * Fetches a modifiable reference to the value at index 'key'
+			 * in the Array this value represents.
+			 *
+			 * As with operator[](const char*), the reference is meant for
+			 * immediate use.
+			 *
+			 * @note Prefer the const overload when only reading, since this
+			 *       one unpacks a packed Array, so asIntSpan() and
+			 *       asDoubleSpan() no longer apply to it, and copies the
+			 *       Array first if it is shared with another Value.
+			 *
+			 * @param key The index to use to retrieve the value.
+			 * @throws Json::Exception If the index is outside of the Array bounds.
+			 * @returns The value at index key.
+			 */
+			Value&
+			operator[](int key) throw (Json::Exception);
+
+			/**
+			 * Fetches a modifiable reference to the value defined by a
+			 * precomputed key in the Object this value represents. As with
+			 * operator[](const char*), the reference is meant for
+			 * immediate use.
+			 *
+			 * @param key The key to use to retrieve the value.
+			 * @throws Json::Exception If this is not an Object or the key
+			 *                         does not exist in it.
+			 * @returns The value identified by key.
+			 */
+			Value&
+			operator[](const Json::Key& key) throw (Json::Exception);
+
+			/**
+			 * Sets 'key' in the Object this value represents to 'v',
+			 * replacing any previous value. A null value becomes an
+			 * empty Object first.
+			 *
+			 * @param key The key to set.
+			 * @param v   The value to store. It is moved into the Object.
+			 * @throws Json::Exception If this is neither an Object nor null.
+			 * @returns The stored value.
+			 */
+			Value&
+			set(Json::StringView key, Value v) throw (Json::Exception);
+
+			/**
+			 * Removes 'key' from the Object this value represents.
+			 *
+			 * @param key The key to remove.
+			 * @throws Json::Exception If this is not an Object.
+			 * @returns True if the key existed, false otherwise.
+			 */
+			bool
+			erase(Json::StringView key) throw (Json::Exception);
+
+			/**
+			 * Removes the value at index 'key' from the Array this value
+			 * represents. Subsequent values are shifted down one index.
+			 *
+			 * @param key The index to remove.
+			 * @throws Json::Exception If this is not an Array or the index
+			 *                         is outside of the Array bounds.
+			 */
+			void
+			erase(int key) throw (Json::Exception);
+
+			/**
+			 * Appends 'v' to the Array this value represents.
+			 * A null value becomes an empty Array first.
+			 *
+			 * @param v The value to append. It is moved into the Array.
+			 * @throws Json::Exception If this is neither an Array nor null.
+			 * @returns The appended value.
+			 */
+			Value&
+			push_back(Value v) throw (Json::Exception);
+
+			/**
+			 * Inserts 'v' before index 'key' in the Array this value
+			 * represents. An index equal to the Array size appends.
+			 *
+			 * @param key The index to insert at.
+			 * @param v   The value to insert. It is moved into the Array.
+			 * @throws Json::Exception If this is not an Array or the index
+			 *                         is outside of the Array bounds.
+			 * @returns The inserted value.
+			 */
+			Value&
+			insert(int key, Value v) throw (Json::Exception);
+
 			/**
 			 * Get the value as an Array.
 			 *
@@ -254,7 +586,16 @@ namespace Json {
 			 * @see get()
 			 * @returns Json::Array The array this value represents
 			 */
-			Json::Array asArray() const throw (Json::Exception);
+			const Json::Array& asArray() const throw (Json::Exception);
+
+			/**
+			 * Get the value as a modifiable Array.
+			 *
+			 * @throws Json::Exception If current value cannot be
+			 *                         interpreted as an Array.
+			 * @returns Json::Array The array this value represents
+			 */
+			Json::Array& asArray() throw (Json::Exception);
 
 			/**
 			 * Get the value as a JsonObject.
@@ -265,18 +606,53 @@ namespace Json {
 			 * @see Json::Object
 			 * @see get()
 			 */
-			Json::Object asObject() const throw (Json::Exception);
+			const Json::Object& asObject() const throw (Json::Exception);
+
+			/**
+			 * Get the value as a modifiable JsonObject.
+			 *
+			 * @throws Json::Exception If current value cannot be
+			 *                         interpreted as an Object
+			 * @returns Json::Object The object this value represents
+			 */
+			Json::Object& asObject() throw (Json::Exception);
 
 			/**
 			 * Get the value as an integer.
 			 *
 			 * @returns The JSON number as an integer.
 			 * @throws Json::Exception If current value cannot be
-			 *                         interpreted as an integer.
+			 *                         interpreted as an integer, or
+			 *                         is a number which is not an integer
+			 *                         or does not fit in one.
 			 * @see get()
 			 */
 			Json::Int asInt() const throw (Json::Exception);
 
+			/**
+			 * Get the value as a 64-bit integer.
+			 *
+			 * @returns The JSON number as a 64-bit integer.
+			 * @throws Json::Exception If current value cannot be
+			 *                         interpreted as an integer, or
+			 *                         is a number which is not an integer
+			 *                         or does not fit in one.
+			 * @see isInteger()
+			 */
+			Json::Int64 asInt64() const throw (Json::Exception);
+
+			/**
+			 * Get the value as an unsigned 64-bit integer.
+			 *
+			 * @returns The JSON number as an unsigned 64-bit integer.
+			 * @throws Json::Exception If current value cannot be
+			 *                         interpreted as an integer, or
+			 *                         is a number which is not an integer,
+			 *                         is negative or does not fit in one.
+			 * @see isInteger()
+			 */
+			Json::UInt64 asUInt64() const throw (Json::Exception);
+
 			/**
 			 * Get the value as a number.
 			 *
@@ -308,7 +684,113 @@ namespace Json {
 			 * @see Json::String
 			 * @see get()
 			 */
-			Json::String asString() const throw (Json::Exception);
+			const Json::String& asString() const throw (Json::Exception);
+
+			/**
+			 * Get the value as a view of the string it holds. The view
+			 * is valid for as long as this value is neither modified nor destroyed.
+			 *
+			 * @returns The value as a string view.
+			 * @throws Json::Exception If current value cannot be
+			 *                         interpreted as a string
+			 * @see asString()
+			 */
+			Json::StringView asStringView() const throw (Json::Exception);
+
+			/**
+			 * Get the serialized JSON this value holds.
+			 *
+			 * @returns The fragment.
+			 * @throws Json::Exception If this is not a JVRAW value.
+			 * @see Json::RawJson
+			 */
+			const Json::RawJson& asRawJson() const throw (Json::Exception);
+
+			/**
+			 * Iterator over the members of an Array.
+			 */
+			typedef Json::Array::const_iterator const_iterator;
+
+			/**
+			 * Range of the members of an Array.
+			 */
+			typedef Json::Range<Json::Array::const_iterator> ElementRange;
+
+			/**
+			 * Range of the key, value pairs of an Object.
+			 */
+			typedef Json::Range<Json::Object::const_iterator> ItemRange;
+
+			/**
+			 * The first member of the Array this value represents.
+			 * Together with end() this allows iterating an Array
+			 * in a range based for loop without copying it:
+			 * @code
+			 * for (const Json::Value& v : array) { ... }
+			 * @endcode
+			 *
+			 * @throws Json::Exception If this is not an Array.
+			 */
+			const_iterator begin() const throw (Json::Exception);
+
+			/**
+			 * One past the last member of the Array this value represents.
+			 *
+			 * @throws Json::Exception If this is not an Array.
+			 */
+			const_iterator end() const throw (Json::Exception);
+
+			/**
+			 * The members of the Array this value represents.
+			 *
+			 * @throws Json::Exception If this is not an Array.
+			 */
+			ElementRange elements() const throw (Json::Exception);
+
+			/**
+			 * The key, value pairs of the Object this value represents,
+			 * ordered by key:
+			 * @code
+			 * for (const auto& item : object.items()) {
+			 *   std::cout << item.first << " : " << item.second.asInt();
+			 * }
+			 * @endcode
+			 *
+			 * @throws Json::Exception If this is not an Object.
+			 */
+			ItemRange items() const throw (Json::Exception);
+
+			/**
+			 * Get the members of an Array holding only numbers as
+			 * contiguous doubles, without copying them.
+			 *
+			 * Arrays parsed from JSON holding only numbers, where at least
+			 * one is not an integer, are packed as doubles. So are Arrays
+			 * created from std::vector<double>. An Array is unpacked once
+			 * it is modified, indexed through a non-const Value or fetched
+			 * with the non-const asArray().
+			 *
+			 * @throws Json::Exception If this is not an Array packed as doubles.
+			 * @returns The members of the Array.
+			 * @see asIntSpan()
+			 */
+			Json::DoubleSpan asDoubleSpan() const throw (Json::Exception);
+
+			/**
+			 * Get the members of an Array holding only integers as
+			 * contiguous 64-bit integers, without copying them.
+			 *
+			 * Arrays parsed from JSON holding only integers are packed
+			 * as integers. So are Arrays created from std::vector<int>
+			 * and std::vector<int64_t>. An Array is unpacked once it is
+			 * modified, indexed through a non-const Value or fetched with
+			 * the non-const asArray().
+			 *
+			 * @throws Json::Exception If this is not an Array packed as integers.
+			 * @returns The members of the Array.
+			 * @see asDoubleSpan()
+			 */
+			Json::IntSpan asIntSpan() const throw (Json::Exception);
 
 			/**
 			 * Determines whether this JSON value is null or not.
@@ -318,6 +800,44 @@ namespace Json {
 			 */
 			bool isNull() const;
 
+			/**
+			 * Determines whether this is a JSON number stored as an
+			 * integer, i.e. whether asInt64() or asUInt64() returns it
+			 * without truncation.
+			 *
+			 * @return True if this is an integral number, false otherwise.
+			 */
+			bool isInteger() const;
+
+			/**
+			 * Tells whether 'v' holds the same JSON as this value. Objects
+			 * are equal when they have the same keys with equal values,
+			 * Arrays when they have equal members in the same order, and
+			 * numbers when they are the same number, however they are
+			 * stored; 1 equals 1.0. Nothing is allocated, except to parse
+			 * Json::RawJson fragments, which are compared by what they hold.
+			 *
+			 * Objects and Arrays held by both values, e.g. because one is
+			 * a copy of the other, are not compared member by member.
+			 */
+			bool operator==(const Json::Value& v) const;
+			bool operator!=(const Json::Value& v) const { return !(*this == v); }
+
+			/**
+			 * A hash of the JSON this value holds. Values which are equal
+			 * have the same hash, see operator==(). The hash only depends
+			 * on the JSON, so it is the same in every process and on every
+			 * platform, and may be stored.
+			 *
+			 * The hashes of Objects and Arrays are kept with them, until
+			 * they are modified, so hashing a value again only hashes what
+			 * was modified since. As with Json::serializeMemoized, no hash
+			 * is kept for Objects and Arrays which have handed out a
+			 * modifiable reference, until they are next modified through
+			 * set(), erase(), push_back() or insert().
+			 */
+			Json::UInt64 hash() const;
+
 			/**
 			 * Minifies the JSON string, removing any insignificant characters
 			 * from a json point of view (insignificant white-spaces).
@@ -325,22 +845,37 @@ namespace Json {
 			 * @param json The JSON string to minify.
 			 * @returns The minified string.
 			 */
-			static std::string minify(std::string);
+			static std::string minify(const std::string&);
 
 		private:
 			/**
-			 * The mode with which this class can be instantiated.
-			 *
-			 * @see Value(std::string, cmode)
+			 * Strings up to this length are stored inline rather
+			 * than shared, since copying them does not allocate.
 			 */
-			enum cmode {
-				MODE_PARSE
-			};
+			static const size_t INLINE_STRING_MAX = 15;
+
+			/**
+			 * How a value is stored. This mirrors Json::value_t, but
+			 * Objects, Arrays and longer Strings are held by Json::Shared.
+			 */
+			typedef boost::variant<Json::NullValue,
+			                       Json::Bool,
+			                       Json::Int,
+			                       Json::Int64,
+			                       Json::UInt64,
+			                       Json::Number,
+			                       Json::String,
+			                       Json::Shared<Json::String>,
+			                       Json::Shared<Json::Object>,
+			                       Json::Shared<Json::Array>,
+			                       Json::Shared<Json::PackedArray<double> >,
+			                       Json::Shared<Json::PackedArray<int64_t> >,
+			                       Json::RawJson> storage_t;
 
 			/**
 			 * The value held by this instance.
 			 */
-			Json::value_t value;
+			storage_t value;
 
 			/**
 			 * The type of the value held by this instance.
@@ -349,21 +884,20 @@ namespace Json {
 
 
 			/**
-			 * Creates a Value using specified mode.
-			 *  - MODE_PARSE: Provided string is a JSON string.
+			 * Creates a Value and sets it to the provided value.
+			 * The type is derived from the input value.
 			 *
-			 *  @param json The json string
-			 *  @param m    The mode of how to interpret the JSON string.
+			 * @param v The value this instance should represent.
 			 */
-			Value(std::string json, cmode m) throw (Json::Exception);
+			Value(const Json::value_t& v);
 
 			/**
-			 * Creates a Value and sets it to the provided value.
-			 * The type is derived from the input value.
+			 * Creates a Value by taking over the provided value.
+			 * Strings, Objects and Arrays are moved, not copied.
 			 *
 			 * @param v The value this instance should represent.
 			 */
-			Value(Json::value_t v);
+			Value(Json::value_t&& v);
 
 			/**
 			 * Tells the type of a Json::value_t.
@@ -373,25 +907,81 @@ namespace Json {
 			 * @see getType()
 			 * @see Json::Types
 			 */
-			static Json::Types typeByValue(Json::value_t v) throw (Json::Exception);
+			static Json::Types typeByValue(const Json::value_t& v) throw (Json::Exception);
+
+			/**
+			 * Converts a Json::value_t into how it is stored.
+			 *
+			 * @param v The value to store. Its String, Object or
+			 *          Array is moved from.
+			 * @returns The storage for v.
+			 */
+			static storage_t store(Json::value_t& v);
+
+			/**
+			 * Converts a string into how it is stored; inline or shared
+			 * depending on its length.
+			 *
+			 * @param str The string to store. It is moved from.
+			 */
+			static storage_t store(Json::String&& str);
+
+			/**
+			 * Converts an Array into how it is stored; packed if it holds
+			 * only numbers, shared otherwise.
+			 *
+			 * @param arr The Array to store. It is moved from.
+			 */
+			static storage_t store(Json::Array&& arr);
 
 			/**
-			 * Remove any escape characters (\) from the string.
+			 * Creates an Array packed as doubles.
 			 *
-			 * @param std::string The string to remove escape characters from.
-			 * @returns The unescaped string.
+			 * @param v The members of the Array. It is moved from.
 			 */
-			void unescape(std::string&) const;
+			explicit Value(std::vector<double>&& v);
 
 			/**
-			 * Prepends any occurance of c with an escape character (\).
+			 * Creates an Array packed as integers.
 			 *
-			 * @note This changes the input variable.
+			 * @param v The members of the Array. It is moved from.
+			 */
+			explicit Value(std::vector<int64_t>&& v);
+
+			/**
+			 * Fetches the Array this value represents, expanding
+			 * a packed Array into Json::Value members if needed.
 			 *
-			 * @param strjson The string to escape.
-			 * @param c       The character which needs to be escaped.
+			 * @returns The Array, or NULL if this is not an Array.
 			 */
-			void escape(std::string&, const char) const;
+			const Json::Array* array() const;
+
+			/**
+			 * Expands a packed Array into Json::Value members. This is
+			 * done once per packed Array; the result is kept with it.
+			 */
+			template <class T> static const Json::Array&
+			expand(const Json::PackedArray<T>& packed);
+
+			/**
+			 * Fetches a reference to the value held, as type T.
+			 *
+			 * @throws Json::Exception If the value is not of type T.
+			 */
+			template <class T> const T&
+			ref() const throw (Json::Exception);
+
+			template <class T> T&
+			ref() throw (Json::Exception);
+
+			/**
+			 * Fetches the shared storage of the Object or Array this
+			 * value represents, unpacking a packed Array first.
+			 *
+			 * @throws Json::Exception If the value is not of type T.
+			 */
+			template <class T> Json::Shared<T>&
+			storage() throw (Json::Exception);
 
 			/**
 			 * Returns a JSON string representation of this value.
@@ -404,53 +994,153 @@ namespace Json {
 			 */
 			std::string strjson(strformat t = FORMAT_PRETTY) const;
 
-			void formatStringForOutput(std::string&) const;
+			/**
+			 * The state of one serialization: where the output goes, how
+			 * it is formatted and how deep into the tree it has come.
+			 * Each call to strjson() has a context of its own, so nothing
+			 * is shared between values serialized at the same time.
+			 */
+			struct StrjsonContext
+			{
+				std::string& out;
+				strformat    format;
+				size_t       indent;
+
+				/** What goes between a key and its value. */
+				const char  *colon;
+
+				/**
+				 * Whether the output of Objects and Arrays is kept with them,
+				 * and reused while they are not modified.
+				 */
+				bool         memoize;
+
+				/**
+				 * Whether the output is canonical, see Json::serializeCanonical.
+				 * Nothing which was kept is used then.
+				 */
+				bool         canonical;
+
+				StrjsonContext(std::string& out, strformat format)
+					: out(out), format(format), indent(0),
+					  colon(FORMAT_PRETTY == format ? " : " : ":"), memoize(false), canonical(false) {}
+			};
 
 			/**
-			 * Extracts a literal from string str starting at position pos.
-			 * The literal extracted will be as defined in RFC4627.
-			 * If pos in str does is nothing which could be a literal,
-			 * an exception is thrown.
+			 * Appends the JSON string representation of this value to 'out'.
+			 * The whole tree is written in one pass, straight into 'out';
+			 * whitespace is only written when the format asks for it.
 			 *
-			 * @param std::string The string from where the literal should be extraced.
-			 * @param size_t The position the literal starts at.
-			 * @throws Json::Exception
-			 * @returns The extracted literal.
+			 * @param out The string to append to.
+			 * @param t   The format to write. See strformat for allowed values.
+			 */
+			void strjson(std::string& out, strformat t) const;
+
+			/**
+			 * Appends this value at the position described by 'ctx'.
 			 */
-			std::string extractLiteral(std::string, size_t) throw (Json::Exception);
+			void strjson(StrjsonContext& ctx) const;
 
 			/**
-			 * Extracts the string which starts at position pos. It finds which
-			 * delimiter is used at this position ('{', '[' or '"') and returns
-			 * the full string enclosed by these characters. If no closing token
-			 * is found an exception is thrown.
+			 * Appends 'str' to 'out' as a quoted JSON string,
+			 * escaping characters which need to be escaped.
+			 */
+			static void strjsonString(std::string& out, Json::StringView str);
+
+			/**
+			 * Appends what goes before a member of an Object or Array. In pretty
+			 * format each member is on a line of its own, indented by tabs.
 			 *
-			 * If neither of the starting tokens described above is in 'str' at
-			 * position 'pos', a literal will be assumed and all characters to the
-			 * first white-space character (as described in RFC4627) will be returned.
+			 * @param first Whether this is the first member.
+			 */
+			static void strjsonSeparator(StrjsonContext& ctx, bool first);
+
+			/**
+			 * Appends the opening delimiter 'c' of an Object or Array,
+			 * and enters it.
+			 */
+			static void strjsonOpen(StrjsonContext& ctx, char c);
+
+			/**
+			 * Leaves the current Object or Array, and appends
+			 * its closing delimiter 'c'.
+			 */
+			static void strjsonClose(StrjsonContext& ctx, char c);
+
+			/**
+			 * Appends a number to 'out'.
+			 */
+			static void strjsonNumber(std::string& out, Json::Int64 i);
+			static void strjsonNumber(std::string& out, Json::UInt64 i);
+			static void strjsonNumber(std::string& out, Json::Number n);
+
+			template <class T> static void
+			strjsonPacked(StrjsonContext& ctx, const Json::Shared<Json::PackedArray<T> >& packed);
+
+			/**
+			 * Appends the output kept with 'shared' by keepSource(), or
+			 * by strjsonMemoize() if the context memoizes, if there is
+			 * output for the format and depth of the context.
 			 *
-			 * @param std::string The string which contains the literal string
-			 * @param size_t      The position to start at.
-			 * @param bool        Keeps the delimiters in the returned string (e.g. { or ")
-			 * @throws Json::Exception
-			 * @return The extracted string.
+			 * @returns Whether anything was appended.
 			 */
-			std::string extract(std::string, size_t, bool) throw (Json::Exception);
+			template <class T> static bool
+			strjsonRecall(StrjsonContext& ctx, const Json::Shared<T>& shared);
 
-			void parse(std::string) throw (Json::Exception);
-			void parseString(std::string) throw (Json::Exception);
-			void parseNumber(std::string) throw (Json::Exception);
-			void parseBool(std::string) throw (Json::Exception);
-			void parseNull(std::string) throw (Json::Exception);
-			void parseObject(std::string) throw (Json::Exception);
-			void parseArray(std::string) throw (Json::Exception);
+			/**
+			 * Keeps what was appended to the output from 'start' on with
+			 * 'shared', if the context memoizes and it is worth keeping.
+			 */
+			template <class T> static void
+			strjsonMemoize(StrjsonContext& ctx, const Json::Shared<T>& shared, size_t start);
 
-			void strjsonObject(std::string&, size_t) const;
-			void strjsonArray(std::string&, size_t) const;
-			void strjsonNumber(std::string&) const;
-			void strjsonString(std::string&) const;
+			/**
+			 * Appends the output kept with this Object or Array, if there
+			 * is any for the context. Other values have none.
+			 *
+			 * @returns Whether anything was appended.
+			 */
+			bool strjsonKept(StrjsonContext& ctx) const;
+
+			/**
+			 * Keeps 'raw', the minified JSON this Object or Array was
+			 * parsed from, as its minified output. 'raw' is part of
+			 * 'source', which is kept alive along with it.
+			 */
+			void keepSource(Json::StringView raw, const std::shared_ptr<const std::string>& source);
+
+			/**
+			 * The number of characters strjson() writes for this value,
+			 * when it starts at depth 'indent'. Nothing is written.
+			 */
+			size_t strjsonSize(strformat t, size_t indent) const;
+
+			/**
+			 * The number of characters strjsonString() writes for 'str'.
+			 */
+			static size_t strjsonStringSize(Json::StringView str);
+
+			/**
+			 * The number of characters written around the 'members' members
+			 * of an Object or Array at depth 'indent': the delimiters, the
+			 * separators and, in pretty format, the newlines and indentation.
+			 */
+			static size_t strjsonContainerSize(strformat t, size_t indent, size_t members);
+
+			void strjsonObject(StrjsonContext&) const;
+			void strjsonArray(StrjsonContext&) const;
+			void strjsonNumber(StrjsonContext&) const;
 			void strjsonBool(std::string&) const;
 			void strjsonNull(std::string&) const;
+			void strjsonRaw(StrjsonContext&) const;
+
+			/**
+			 * Appends a number as canonical output writes it: as an
+			 * integer if it is one, and as strjsonNumber() writes it
+			 * otherwise.
+			 */
+			static void strjsonCanonical(std::string& out, Json::Number n);
+			static void strjsonCanonical(std::string& out, Json::Int64 i) { strjsonNumber(out, i); }
 
 			/**
 			 * Copies a provided value into this.
@@ -462,6 +1152,58 @@ namespace Json {
 			static void deleteObject(Json::Object obj);
 			static void deleteArray(Json::Array arr);
 	};
+
+	/// Numbers of an Array stored without a Json::Value per member.
+	/**
+	 * Arrays holding only numbers are stored as one contiguous buffer
+	 * of T, see Json::Value::asDoubleSpan() and Json::Value::asIntSpan().
+	 *
+	 * Accessors which return references to Json::Value members of an Array
+	 * (e.g. asArray() or operator[]) need those members to exist. They are
+	 * created on first use and kept alongside the packed numbers.
+	 *
+	 * @tparam T double or int64_t.
+	 */
+	template <class T>
+	class PackedArray
+	{
+		public:
+			/** The members of the Array. */
+			std::vector<T> values;
+
+			/** The members as Json::Value, once expanded. */
+			mutable std::atomic<Json::Array*> expanded;
+
+			PackedArray(std::vector<T>&& values) : values(std::move(values)), expanded(NULL) {}
+
+			PackedArray(const PackedArray& p) : values(p.values), expanded(NULL) {}
+
+			PackedArray(PackedArray&& p) : values(std::move(p.values)), expanded(p.expanded.exchange(NULL)) {}
+
+			~PackedArray()
+			{
+				delete this->expanded.load();
+			}
+
+		private:
+			PackedArray& operator=(const PackedArray&);
+	};
+}
+
+namespace std {
+
+	/**
+	 * Allows Json::Value as the key of unordered containers.
+	 * @see Json::Value::hash()
+	 */
+	template <>
+	struct hash<Json::Value>
+	{
+		size_t operator()(const Json::Value& v) const
+		{
+			return static_cast<size_t>(v.hash());
+		}
+	};
 }
 
-#endif
+#endif
\ No newline at end of file
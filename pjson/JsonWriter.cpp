@@ -0,0 +1,258 @@
+#include "JsonWriter.hpp"
+
+#include <errno.h>
+#include <unistd.h>
+
+static void
+writeStream(std::ostream *os, const char *data, size_t length)
+{
+	if (!os->write(data, length)) throw Json::Exception("Could not write to stream.");
+}
+
+static void
+writeFd(int fd, const char *data, size_t length)
+{
+	while (length > 0) {
+		ssize_t n = ::write(fd, data, length);
+		if (n < 0) {
+			if (EINTR == errno) continue;
+			throw Json::Exception("Could not write to file descriptor.");
+		}
+		data   += n;
+		length -= n;
+	}
+}
+
+Json::Writer::Writer(std::ostream& os, strformat format, size_t size)
+	: sink(std::bind(writeStream, &os, std::placeholders::_1, std::placeholders::_2)),
+	  ctx(buffer, format)
+{
+	this->init(size);
+}
+
+Json::Writer::Writer(int fd, strformat format, size_t size)
+	: sink(std::bind(writeFd, fd, std::placeholders::_1, std::placeholders::_2)),
+	  ctx(buffer, format)
+{
+	this->init(size);
+}
+
+Json::Writer::Writer(const Sink& sink, strformat format, size_t size)
+	: sink(sink),
+	  ctx(buffer, format)
+{
+	this->init(size);
+}
+
+void
+Json::Writer::init(size_t size)
+{
+	this->size = size;
+	this->done = false;
+	this->buffer.reserve(size);
+}
+
+Json::Writer::~Writer()
+{
+	try {
+		this->flush();
+	} catch (Json::Exception) {}
+}
+
+void
+Json::Writer::flush() throw (Json::Exception)
+{
+	if (this->buffer.empty()) return;
+
+	this->sink(this->buffer.data(), this->buffer.size());
+	this->buffer.clear();
+}
+
+bool
+Json::Writer::complete() const
+{
+	return this->done;
+}
+
+void
+Json::Writer::before() throw (Json::Exception)
+{
+	if (this->levels.empty()) {
+		if (this->done) throw Json::Exception("Document is already complete.");
+		return;
+	}
+
+	Level& level = this->levels.back();
+	if (level.object) {
+		if (!level.keyed) throw Json::Exception("Value in Object without a key.");
+		level.keyed = false;
+		return;
+	}
+
+	Json::Value::strjsonSeparator(this->ctx, level.empty);
+	level.empty = false;
+}
+
+void
+Json::Writer::after() throw (Json::Exception)
+{
+	if (this->levels.empty()) this->done = true;
+	if (this->buffer.size() >= this->size) this->flush();
+}
+
+Json::Writer&
+Json::Writer::beginObject() throw (Json::Exception)
+{
+	this->before();
+	Json::Value::strjsonOpen(this->ctx, '{');
+
+	Level level = { true, true, false };
+	this->levels.push_back(level);
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::beginArray() throw (Json::Exception)
+{
+	this->before();
+	Json::Value::strjsonOpen(this->ctx, '[');
+
+	Level level = { false, true, false };
+	this->levels.push_back(level);
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::end(bool object) throw (Json::Exception)
+{
+	if (this->levels.empty() || object != this->levels.back().object) {
+		throw Json::Exception(object ? "Not in an Object." : "Not in an Array.");
+	}
+	if (this->levels.back().keyed) throw Json::Exception("Key without a value.");
+
+	this->levels.pop_back();
+	Json::Value::strjsonClose(this->ctx, object ? '}' : ']');
+	this->after();
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::endObject() throw (Json::Exception)
+{
+	return this->end(true);
+}
+
+Json::Writer&
+Json::Writer::endArray() throw (Json::Exception)
+{
+	return this->end(false);
+}
+
+Json::Writer&
+Json::Writer::key(Json::StringView key) throw (Json::Exception)
+{
+	if (this->levels.empty() || !this->levels.back().object) {
+		throw Json::Exception("Key outside of an Object.");
+	}
+
+	Level& level = this->levels.back();
+	if (level.keyed) throw Json::Exception("Key without a value.");
+
+	Json::Value::strjsonSeparator(this->ctx, level.empty);
+	Json::Value::strjsonString(this->buffer, key);
+	this->buffer += this->ctx.colon;
+
+	level.empty = false;
+	level.keyed = true;
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::value(Json::StringView str) throw (Json::Exception)
+{
+	this->before();
+	Json::Value::strjsonString(this->buffer, str);
+	this->after();
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::value(const char *str) throw (Json::Exception)
+{
+	return this->value(Json::StringView(str));
+}
+
+Json::Writer&
+Json::Writer::value(const std::string& str) throw (Json::Exception)
+{
+	return this->value(Json::StringView(str));
+}
+
+Json::Writer&
+Json::Writer::value(Json::Int i) throw (Json::Exception)
+{
+	return this->value(Json::Int64(i));
+}
+
+Json::Writer&
+Json::Writer::value(Json::Int64 i) throw (Json::Exception)
+{
+	this->before();
+	Json::Value::strjsonNumber(this->buffer, i);
+	this->after();
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::value(Json::UInt64 i) throw (Json::Exception)
+{
+	this->before();
+	Json::Value::strjsonNumber(this->buffer, i);
+	this->after();
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::value(Json::Number n) throw (Json::Exception)
+{
+	this->before();
+	Json::Value::strjsonNumber(this->buffer, n);
+	this->after();
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::value(Json::Bool b) throw (Json::Exception)
+{
+	this->before();
+	this->buffer += (b ? "true" : "false");
+	this->after();
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::value(const Json::Value& v) throw (Json::Exception)
+{
+	this->before();
+	v.strjson(this->ctx);
+	this->after();
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::value(const Json::RawJson& raw) throw (Json::Exception)
+{
+	this->before();
+	this->buffer.append(raw.json().data(), raw.json().length());
+	this->after();
+	return *this;
+}
+
+Json::Writer&
+Json::Writer::null() throw (Json::Exception)
+{
+	this->before();
+	this->buffer += "null";
+	this->after();
+	return *this;
+}
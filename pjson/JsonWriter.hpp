@@ -0,0 +1,175 @@
+#ifndef __JSONWRITER_HPP__
+#define __JSONWRITER_HPP__
+
+#include "JsonValue.hpp"
+#include "JsonException.hpp"
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Json {
+
+	/// Writes JSON incrementally, without building a Json::Value.
+	/**
+	 * The document is described one call at a time and written through
+	 * a buffer of bounded size to a std::ostream, a file descriptor or
+	 * a user supplied sink. Whenever the buffer reaches its size it is
+	 * handed to the destination and reused, so arbitrarily large
+	 * documents can be written in constant memory:
+	 * @code
+	 * Json::Writer w(std::cout);
+	 * w.beginArray();
+	 * while (row = next()) {
+	 *   w.beginObject();
+	 *   w.key("id").value(row->id);
+	 *   w.key("name").value(row->name);
+	 *   w.endObject();
+	 * }
+	 * w.endArray();
+	 * w.flush();
+	 * @endcode
+	 *
+	 * The output is formatted exactly as Json::serialize formats the
+	 * corresponding Json::Value. Calls which would produce invalid JSON
+	 * (e.g. a value in an Object without a key) throw Json::Exception.
+	 *
+	 * @note A single value is always buffered whole, so writing a large
+	 *       Json::Value through value() needs memory for all of its output.
+	 */
+	class Writer
+	{
+		public:
+			/**
+			 * A destination for the output. Called with consecutive
+			 * chunks of the document.
+			 */
+			typedef std::function<void (const char *data, size_t length)> Sink;
+
+			/** The default size of the buffer, in bytes. */
+			static const size_t BUFFER_SIZE = 64 * 1024;
+
+			/**
+			 * Writes to a std::ostream.
+			 *
+			 * @param os     The stream to write to. Must outlive the writer.
+			 * @param format How to format the output.
+			 * @param size   The size of the buffer, in bytes.
+			 */
+			Writer(std::ostream& os, strformat format = FORMAT_MINIFIED, size_t size = BUFFER_SIZE);
+
+			/**
+			 * Writes to a file descriptor, e.g. a socket.
+			 *
+			 * @param fd     The file descriptor to write to. It is not closed.
+			 * @param format How to format the output.
+			 * @param size   The size of the buffer, in bytes.
+			 */
+			Writer(int fd, strformat format = FORMAT_MINIFIED, size_t size = BUFFER_SIZE);
+
+			/**
+			 * Writes to a user supplied sink.
+			 *
+			 * @param sink   Called with each chunk of output.
+			 * @param format How to format the output.
+			 * @param size   The size of the buffer, in bytes.
+			 */
+			Writer(const Sink& sink, strformat format = FORMAT_MINIFIED, size_t size = BUFFER_SIZE);
+
+			/**
+			 * Flushes what is left in the buffer. Errors are ignored;
+			 * call flush() first to have them reported.
+			 */
+			~Writer();
+
+			/** Starts an Object. */
+			Writer& beginObject() throw (Json::Exception);
+
+			/** Ends the current Object. */
+			Writer& endObject() throw (Json::Exception);
+
+			/** Starts an Array. */
+			Writer& beginArray() throw (Json::Exception);
+
+			/** Ends the current Array. */
+			Writer& endArray() throw (Json::Exception);
+
+			/**
+			 * Writes the key of the next member of the current Object.
+			 * It must be followed by exactly one value.
+			 */
+			Writer& key(Json::StringView key) throw (Json::Exception);
+
+			Writer& value(Json::StringView str) throw (Json::Exception);
+			Writer& value(const char *str) throw (Json::Exception);
+			Writer& value(const std::string& str) throw (Json::Exception);
+			Writer& value(Json::Int i) throw (Json::Exception);
+			Writer& value(Json::Int64 i) throw (Json::Exception);
+			Writer& value(Json::UInt64 i) throw (Json::Exception);
+			Writer& value(Json::Number n) throw (Json::Exception);
+			Writer& value(Json::Bool b) throw (Json::Exception);
+
+			/**
+			 * Writes a complete Json::Value, e.g. a subtree which
+			 * was parsed or built elsewhere.
+			 */
+			Writer& value(const Json::Value& v) throw (Json::Exception);
+
+			/**
+			 * Writes JSON which is serialized already, as it is.
+			 */
+			Writer& value(const Json::RawJson& raw) throw (Json::Exception);
+
+			/** Writes null. */
+			Writer& null() throw (Json::Exception);
+
+			/**
+			 * Hands everything buffered so far to the destination.
+			 *
+			 * @throws Json::Exception If writing to the destination failed.
+			 */
+			void flush() throw (Json::Exception);
+
+			/**
+			 * Tells whether a complete document has been written.
+			 */
+			bool complete() const;
+
+		private:
+			struct Level
+			{
+				bool object;
+				bool empty;
+				bool keyed;
+			};
+
+			Sink                        sink;
+			size_t                      size;
+			std::string                 buffer;
+			Json::Value::StrjsonContext ctx;
+			std::vector<Level>          levels;
+			bool                        done;
+
+			Writer(const Writer&);
+			Writer& operator=(const Writer&);
+
+			void init(size_t size);
+
+			/**
+			 * Writes what goes before a value at the current
+			 * position, or throws if no value is allowed here.
+			 */
+			void before() throw (Json::Exception);
+
+			/**
+			 * Flushes if the buffer is full and marks the document
+			 * complete after its root value.
+			 */
+			void after() throw (Json::Exception);
+
+			Writer& end(bool object) throw (Json::Exception);
+	};
+}
+
+#endif
@@ -0,0 +1,651 @@
+#include "pjson.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <map>
+#include <set>
+
+/*
+ * The spec is read through Json::Reader into these nodes rather than
+ * through Json::deserialize, as Json::Object would sort the members
+ * and the order of the fields is kept in the generated structs.
+ */
+struct Node
+{
+	Json::Reader::Token                        token;
+	std::string                                text;
+	std::vector<std::pair<std::string, Node> > members;
+	std::vector<Node>                          items;
+
+	const Node *get(const char *key) const
+	{
+		for (size_t i = 0; i < this->members.size(); ++i) {
+			if (this->members[i].first == key) return &this->members[i].second;
+		}
+		return NULL;
+	}
+};
+
+struct Field
+{
+	/** The key of the member in JSON. */
+	std::string key;
+	/** The name of the member in C++. */
+	std::string member;
+	std::string type;
+};
+
+struct Struct
+{
+	std::string           name;
+	std::vector<Field>    fields;
+	std::set<std::string> uses;
+};
+
+typedef std::map<std::string, Struct> Structs;
+
+static Node
+readNode(Json::Reader& r, Json::Reader::Token token)
+{
+	Node node;
+	node.token = token;
+
+	switch (token) {
+		case Json::Reader::TOKEN_BEGIN_OBJECT:
+			while (Json::Reader::TOKEN_KEY == r.next()) {
+				std::string key(r.string().data(), r.string().length());
+				node.members.push_back(std::make_pair(key, readNode(r, r.next())));
+			}
+			break;
+
+		case Json::Reader::TOKEN_BEGIN_ARRAY:
+			for (token = r.next(); Json::Reader::TOKEN_END_ARRAY != token; token = r.next()) {
+				node.items.push_back(readNode(r, token));
+			}
+			break;
+
+		case Json::Reader::TOKEN_STRING:
+			node.text.assign(r.string().data(), r.string().length());
+			break;
+
+		default:
+			node.text.assign(r.raw().data(), r.raw().length());
+			break;
+	}
+
+	return node;
+}
+
+static std::string
+file_get_contents(const char *file)
+{
+	std::ifstream ifs(file);
+	if (!ifs.good()) throw std::runtime_error(std::string("Could not read ") + file);
+
+	return std::string(
+		(std::istreambuf_iterator<char>(ifs)),
+		(std::istreambuf_iterator<char>())
+	);
+}
+
+/**
+ * The keywords and alternative tokens of C++, which can not be used as
+ * identifiers.
+ */
+static const std::set<std::string> keywords = {
+	"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+	"case", "catch", "char", "char16_t", "char32_t", "char8_t", "class", "co_await", "co_return",
+	"co_yield", "compl", "concept", "const", "const_cast", "consteval", "constexpr", "constinit",
+	"continue", "decltype", "default", "delete", "do", "double", "dynamic_cast", "else", "enum",
+	"explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if", "inline",
+	"int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr",
+	"operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+	"requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast",
+	"struct", "switch", "template", "this", "thread_local", "throw", "true", "try", "typedef",
+	"typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t",
+	"while", "xor", "xor_eq"
+};
+
+/**
+ * Replaces the characters of 'key' which can not be part of a C++
+ * identifier by '_'.
+ */
+static std::string
+mangle(const std::string& key)
+{
+	std::string id;
+	for (size_t i = 0; i < key.length(); ++i) {
+		id += isalnum(static_cast<unsigned char>(key[i])) ? key[i] : '_';
+	}
+	if (id.empty() || isdigit(static_cast<unsigned char>(id[0]))) id.insert(0, 1, '_');
+	return id;
+}
+
+/**
+ * Turns a JSON key into a C++ identifier. Keywords get a trailing '_'.
+ */
+static std::string
+identifier(const std::string& key)
+{
+	std::string id = mangle(key);
+	if (keywords.count(id)) id += '_';
+	return id;
+}
+
+/**
+ * Adds the field for 'key' to 's', named after the key. The name gets a
+ * trailing '_' if it is that of the struct, which a member can not have.
+ *
+ * @throws std::runtime_error If another field has the same name.
+ */
+static Field&
+addField(Struct& s, const std::string& key)
+{
+	Field f = { key, identifier(key), "" };
+	if (f.member == s.name) f.member += '_';
+
+	for (size_t i = 0; i < s.fields.size(); ++i) {
+		if (s.fields[i].member == f.member) {
+			throw std::runtime_error("Fields " + s.name + "." + s.fields[i].key + " and " + s.name + "." + key +
+			                         " are both named " + f.member);
+		}
+	}
+
+	s.fields.push_back(f);
+	return s.fields.back();
+}
+
+/**
+ * Checks that 'name' may be used as the name of a struct.
+ */
+static const std::string&
+structName(const std::string& name)
+{
+	if (identifier(name) != name) throw std::runtime_error("Invalid struct name: " + name);
+	return name;
+}
+
+static std::string
+capitalize(const std::string& str)
+{
+	std::string id = mangle(str);
+	if ('_' != id[0]) id[0] = toupper(static_cast<unsigned char>(id[0]));
+	return id;
+}
+
+/**
+ * Quotes 'str' as a C++ string literal.
+ */
+static std::string
+literal(const std::string& str)
+{
+	std::string out("\"");
+	for (size_t i = 0; i < str.length(); ++i) {
+		unsigned char c = str[i];
+		if ('"' == c || '\\' == c) {
+			out += '\\';
+			out += c;
+		} else if (c < 0x20 || c >= 0x7f) {
+			/* Always three digits, so a following digit is not taken as part of it. */
+			char octal[5];
+			snprintf(octal, sizeof(octal), "\\%03o", c);
+			out += octal;
+		} else {
+			out += c;
+		}
+	}
+	return out + "\"";
+}
+
+/**
+ * Quotes 'c' as a C++ character literal.
+ */
+static std::string
+character(char c)
+{
+	std::string quoted = literal(std::string(1, c));
+	if ("\"\\\"\"" == quoted) quoted = "\"\"\"";
+	if ("'" == quoted.substr(1, 1)) quoted = "\"\\'\"";
+	quoted[0] = quoted[quoted.length() - 1] = '\'';
+	return quoted;
+}
+
+/**
+ * The field-spec format:
+ * @code
+ * {
+ *   "Episode" : { "name" : "string", "minutes" : "int" },
+ *   "Show"    : { "name" : "string", "episodes" : "[Episode]", "network" : "string?" }
+ * }
+ * @endcode
+ * Types are string, int, int64, uint64, double, bool, any (a Json::Value)
+ * or the name of another struct. [T] is an Array of T, {T} an Object of T
+ * and T? may be null or missing.
+ */
+static std::string
+specType(const std::string& spec, Struct& s)
+{
+	size_t n = spec.length();
+	if (n > 1 && '?' == spec[n - 1]) return "boost::optional<" + specType(spec.substr(0, n - 1), s) + " >";
+	if (n > 2 && '[' == spec[0] && ']' == spec[n - 1]) return "std::vector<" + specType(spec.substr(1, n - 2), s) + " >";
+	if (n > 2 && '{' == spec[0] && '}' == spec[n - 1]) return "std::map<std::string, " + specType(spec.substr(1, n - 2), s) + " >";
+
+	if ("string" == spec) return "std::string";
+	if ("int" == spec)    return "int";
+	if ("int64" == spec)  return "int64_t";
+	if ("uint64" == spec) return "uint64_t";
+	if ("double" == spec) return "double";
+	if ("bool" == spec)   return "bool";
+	if ("any" == spec)    return "Json::Value";
+
+	if (spec.empty() || identifier(spec) != spec) throw std::runtime_error("Invalid type: " + spec);
+	s.uses.insert(spec);
+	return spec;
+}
+
+static void
+readSpec(const Node& root, Structs& structs)
+{
+	for (size_t i = 0; i < root.members.size(); ++i) {
+		const Node& def = root.members[i].second;
+		if (Json::Reader::TOKEN_BEGIN_OBJECT != def.token) {
+			throw std::runtime_error("Expected an Object of fields for " + root.members[i].first);
+		}
+
+		Struct& s = structs[root.members[i].first];
+		s.name = structName(root.members[i].first);
+		for (size_t j = 0; j < def.members.size(); ++j) {
+			if (Json::Reader::TOKEN_STRING != def.members[j].second.token) {
+				throw std::runtime_error("Expected a type for " + s.name + "." + def.members[j].first);
+			}
+			std::string type = specType(def.members[j].second.text, s);
+			addField(s, def.members[j].first).type = type;
+		}
+	}
+}
+
+static void schemaStruct(const std::string& name, const Node& schema, Structs& structs);
+
+/**
+ * The C++ type of a JSON Schema. Objects with properties become structs,
+ * named after the property holding them when they are not definitions.
+ */
+static std::string
+schemaType(const Node& schema, const std::string& name, Struct& parent, Structs& structs, bool& nullable)
+{
+	const Node *ref = schema.get("$ref");
+	if (NULL != ref) {
+		std::string target = ref->text.substr(ref->text.rfind('/') + 1);
+		parent.uses.insert(target);
+		return target;
+	}
+
+	std::string type;
+	const Node *t = schema.get("type");
+	if (NULL != t && Json::Reader::TOKEN_STRING == t->token) {
+		type = t->text;
+	} else if (NULL != t && Json::Reader::TOKEN_BEGIN_ARRAY == t->token) {
+		for (size_t i = 0; i < t->items.size(); ++i) {
+			if ("null" == t->items[i].text) {
+				nullable = true;
+			} else {
+				type = t->items[i].text;
+			}
+		}
+	}
+
+	if ("string" == type)  return "std::string";
+	if ("integer" == type) return "int64_t";
+	if ("number" == type)  return "double";
+	if ("boolean" == type) return "bool";
+
+	if ("array" == type && NULL != schema.get("items")) {
+		bool optional = false;
+		std::string item = schemaType(*schema.get("items"), name + "Item", parent, structs, optional);
+		if (optional) item = "boost::optional<" + item + " >";
+		return "std::vector<" + item + " >";
+	}
+
+	if ("object" == type && NULL != schema.get("properties")) {
+		schemaStruct(name, schema, structs);
+		parent.uses.insert(name);
+		return name;
+	}
+
+	const Node *additional = schema.get("additionalProperties");
+	if ("object" == type && NULL != additional && Json::Reader::TOKEN_BEGIN_OBJECT == additional->token) {
+		bool optional = false;
+		std::string value = schemaType(*additional, name + "Value", parent, structs, optional);
+		if (optional) value = "boost::optional<" + value + " >";
+		return "std::map<std::string, " + value + " >";
+	}
+
+	return "Json::Value";
+}
+
+static void
+schemaStruct(const std::string& name, const Node& schema, Structs& structs)
+{
+	if (!structs[name].name.empty()) throw std::runtime_error("Struct defined twice: " + name);
+
+	Struct s;
+	s.name = structName(name);
+
+	std::set<std::string> required;
+	const Node *req = schema.get("required");
+	if (NULL != req) {
+		for (size_t i = 0; i < req->items.size(); ++i) required.insert(req->items[i].text);
+	}
+
+	const Node& properties = *schema.get("properties");
+	for (size_t i = 0; i < properties.members.size(); ++i) {
+		const std::string& key = properties.members[i].first;
+		bool nullable = !required.count(key);
+
+		std::string type = schemaType(properties.members[i].second, name + capitalize(key), s, structs, nullable);
+		if (nullable && "Json::Value" != type) type = "boost::optional<" + type + " >";
+		addField(s, key).type = type;
+	}
+
+	structs[name] = s;
+}
+
+/**
+ * A JSON Schema. Every entry of "definitions" (or "$defs") becomes a
+ * struct, and so does the schema itself when it has a "title".
+ */
+static void
+readSchema(const Node& root, Structs& structs)
+{
+	const char *sections[] = { "definitions", "$defs" };
+	for (size_t i = 0; i < 2; ++i) {
+		const Node *defs = root.get(sections[i]);
+		if (NULL == defs) continue;
+
+		for (size_t j = 0; j < defs->members.size(); ++j) {
+			if (NULL == defs->members[j].second.get("properties")) {
+				throw std::runtime_error("Definition without properties: " + defs->members[j].first);
+			}
+			schemaStruct(defs->members[j].first, defs->members[j].second, structs);
+		}
+	}
+
+	const Node *title = root.get("title");
+	if (NULL != title && NULL != root.get("properties")) {
+		schemaStruct(identifier(title->text), root, structs);
+	}
+}
+
+static bool
+isSchema(const Node& root)
+{
+	return NULL != root.get("$schema") || NULL != root.get("properties") ||
+	       NULL != root.get("definitions") || NULL != root.get("$defs");
+}
+
+/**
+ * Orders the structs so that each one comes after those it contains.
+ */
+static void
+order(const std::string& name, const Structs& structs, std::set<std::string>& visiting,
+      std::set<std::string>& done, std::vector<const Struct*>& out)
+{
+	if (done.count(name)) return;
+
+	Structs::const_iterator it = structs.find(name);
+	if (structs.end() == it || it->second.name.empty()) throw std::runtime_error("Unknown type: " + name);
+	if (!visiting.insert(name).second) throw std::runtime_error("Struct contains itself: " + name);
+
+	for (std::set<std::string>::const_iterator u = it->second.uses.begin(); u != it->second.uses.end(); ++u) {
+		order(*u, structs, visiting, done, out);
+	}
+
+	done.insert(name);
+	out.push_back(&it->second);
+}
+
+static void
+emitStruct(std::ostream& os, const Struct& s)
+{
+	os << "\tstruct " << s.name << "\n\t{\n";
+	for (size_t i = 0; i < s.fields.size(); ++i) {
+		const Field& f = s.fields[i];
+		os << "\t\t" << f.type << " " << f.member;
+		if ("bool" == f.type) {
+			os << " = false";
+		} else if ("int" == f.type || "int64_t" == f.type || "uint64_t" == f.type || "double" == f.type) {
+			os << " = 0";
+		}
+		os << ";\n";
+	}
+	os << "\t};\n\n";
+}
+
+/**
+ * Emits the lookup of a key among the fields: a switch on the length,
+ * then on the first byte when several fields have that length.
+ */
+static void
+emitLookup(std::ostream& os, const Struct& s)
+{
+	std::map<size_t, std::map<char, std::vector<size_t> > > byLength;
+	for (size_t i = 0; i < s.fields.size(); ++i) {
+		const std::string& key = s.fields[i].key;
+		byLength[key.length()][key.empty() ? '\0' : key[0]].push_back(i);
+	}
+
+	os << "\t\tstatic size_t field(Json::StringView key)\n"
+	   << "\t\t{\n"
+	   << "\t\t\tswitch (key.length()) {\n";
+
+	for (std::map<size_t, std::map<char, std::vector<size_t> > >::const_iterator l = byLength.begin(); l != byLength.end(); ++l) {
+		os << "\t\t\t\tcase " << l->first << ":\n";
+
+		bool first = l->second.size() > 1;
+		if (first) os << "\t\t\t\t\tswitch (key[0]) {\n";
+		for (std::map<char, std::vector<size_t> >::const_iterator c = l->second.begin(); c != l->second.end(); ++c) {
+			const char *indent = first ? "\t\t\t\t\t\t\t" : "\t\t\t\t\t";
+			if (first) os << "\t\t\t\t\t\tcase " << character(c->first) << ":\n";
+			for (size_t i = 0; i < c->second.size(); ++i) {
+				const Field& f = s.fields[c->second[i]];
+				os << indent << "if (0 == memcmp(key.data(), " << literal(f.key) << ", " << f.key.length()
+				   << ")) return " << c->second[i] << ";\n";
+			}
+			os << indent << "break;\n";
+		}
+		if (first) os << "\t\t\t\t\t}\n\t\t\t\t\tbreak;\n";
+	}
+
+	os << "\t\t\t}\n"
+	   << "\t\t\treturn " << s.fields.size() << ";\n"
+	   << "\t\t}\n\n";
+}
+
+static void
+emitTraits(std::ostream& os, const Struct& s, const std::string& scope)
+{
+	const std::string name = scope + s.name;
+	const size_t n = s.fields.size();
+
+	os << "\ttemplate <>\n"
+	   << "\tstruct Traits<" << name << ">\n"
+	   << "\t{\n";
+
+	if (0 == n) {
+		os << "\t\tstatic void read(Json::Reader& r, " << name << "&) throw (Json::Exception)\n"
+		   << "\t\t{\n"
+		   << "\t\t\tJson::readMembers(r, [](Json::StringView) { return false; });\n"
+		   << "\t\t}\n"
+		   << "\t};\n\n";
+	} else {
+		emitLookup(os, s);
+
+		os << "\t\tstatic void read(Json::Reader& r, " << name << "& v) throw (Json::Exception)\n"
+		   << "\t\t{\n"
+		   << "\t\t\tstatic const char *const keys[] = {";
+		for (size_t i = 0; i < n; ++i) os << (i ? ", " : " ") << literal(s.fields[i].key);
+		os << " };\n"
+		   << "\t\t\tstatic const size_t lengths[] = {";
+		for (size_t i = 0; i < n; ++i) os << (i ? ", " : " ") << s.fields[i].key.length();
+		os << " };\n\n"
+		   << "\t\t\tJson::expectToken(r.next(), Json::Reader::TOKEN_BEGIN_OBJECT, \"Expected an Object.\");\n"
+		   << "\t\t\tsize_t i = 0;\n"
+		   << "\t\t\twhile (Json::Reader::TOKEN_KEY == r.next()) {\n"
+		   << "\t\t\t\tJson::StringView key = r.string();\n\n"
+		   << "\t\t\t\t/* Members usually come in the order they are declared in. */\n"
+		   << "\t\t\t\tif (i >= " << n << " || key.length() != lengths[i] || 0 != memcmp(key.data(), keys[i], lengths[i])) {\n"
+		   << "\t\t\t\t\ti = field(key);\n"
+		   << "\t\t\t\t}\n\n"
+		   << "\t\t\t\tswitch (i) {\n";
+		for (size_t i = 0; i < n; ++i) {
+			os << "\t\t\t\t\tcase " << i << ": Json::Traits<decltype(v." << s.fields[i].member << ")>::read(r, v."
+			   << s.fields[i].member << "); break;\n";
+		}
+		os << "\t\t\t\t\tdefault: r.skip(); break;\n"
+		   << "\t\t\t\t}\n"
+		   << "\t\t\t\ti++;\n"
+		   << "\t\t\t}\n"
+		   << "\t\t}\n"
+		   << "\t};\n\n";
+	}
+
+	os << "\ttemplate <>\n"
+	   << "\tstruct Serializer<" << name << ">\n"
+	   << "\t{\n"
+	   << "\t\tstatic void write(Json::Output::Context& ctx, const " << name << "& " << (n ? "v" : "") << ")\n"
+	   << "\t\t{\n"
+	   << "\t\t\tJson::Output::open(ctx, '{');\n";
+	for (size_t i = 0; i < n; ++i) {
+		/* The key is written as it is in the output, quotes and all. */
+		std::string key;
+		Json::serialize(s.fields[i].key, key, Json::FORMAT_MINIFIED);
+
+		os << "\t\t\tJson::Output::member(ctx, " << (i ? "false" : "true") << ");\n"
+		   << "\t\t\tctx.out.append(" << literal(key) << ", " << key.length() << ");\n"
+		   << "\t\t\tctx.out += ctx.colon;\n"
+		   << "\t\t\tJson::serializeTo(ctx, v." << s.fields[i].member << ");\n";
+	}
+	os << "\t\t\tJson::Output::close(ctx, '}');\n"
+	   << "\t\t}\n"
+	   << "\t};\n\n";
+}
+
+static void
+generate(std::ostream& os, const Structs& structs, const std::string& ns, const std::string& guard)
+{
+	std::vector<const Struct*> ordered;
+	std::set<std::string> done;
+	for (Structs::const_iterator it = structs.begin(); it != structs.end(); ++it) {
+		std::set<std::string> visiting;
+		order(it->first, structs, visiting, done, ordered);
+	}
+
+	std::vector<std::string> scopes;
+	for (size_t pos = 0; !ns.empty(); ) {
+		size_t sep = ns.find("::", pos);
+		scopes.push_back(ns.substr(pos, sep - pos));
+		if (std::string::npos == sep) break;
+		pos = sep + 2;
+	}
+	/* Qualified, as a struct may share its name with one in namespace Json. */
+	std::string scope = ns.empty() ? " ::" : " ::" + ns + "::";
+
+	os << "/* Generated by jsoncodegen. Do not edit. */\n"
+	   << "#ifndef " << guard << "\n"
+	   << "#define " << guard << "\n\n"
+	   << "#include <pjson/pjson.hpp>\n"
+	   << "#include <cstring>\n"
+	   << "#include <stdint.h>\n\n";
+
+	for (size_t i = 0; i < scopes.size(); ++i) os << "namespace " << scopes[i] << " {\n";
+	if (!scopes.empty()) os << "\n";
+	for (size_t i = 0; i < ordered.size(); ++i) emitStruct(os, *ordered[i]);
+	for (size_t i = 0; i < scopes.size(); ++i) os << "}\n";
+	if (!scopes.empty()) os << "\n";
+
+	os << "namespace Json {\n\n";
+	for (size_t i = 0; i < ordered.size(); ++i) emitTraits(os, *ordered[i], scope);
+	os << "}\n\n"
+	   << "#endif\n";
+}
+
+static void
+usage(char *argv[])
+{
+	std::cout
+		<< "JSON code generator." << std::endl << std::endl
+		<< "Generates C++ structs from a JSON Schema or a field-spec file, along" << std::endl
+		<< "with specialized Json::Traits and Json::Serializer for each of them," << std::endl
+		<< "so they are read by Json::deserializeInto and written by Json::serialize." << std::endl << std::endl
+		<< "A field-spec file is an Object of structs, each an Object of fields:" << std::endl
+		<< "  { \"Show\" : { \"name\" : \"string\", \"episodes\" : \"[Episode]\", \"network\" : \"string?\" } }" << std::endl
+		<< "Types are string, int, int64, uint64, double, bool, any or a struct;" << std::endl
+		<< "[T] is an Array, {T} an Object and T? may be null or missing." << std::endl << std::endl
+		<< "Usage: " << argv[0] << " [-n namespace] [-o output.hpp] spec.json" << std::endl;
+}
+
+int
+main(int argc, char *argv[])
+{
+	std::string ns, output;
+	const char *input = NULL;
+
+	for (int i = 1; i < argc; ++i) {
+		if (0 == strcmp("-n", argv[i]) && i + 1 < argc) {
+			ns = argv[++i];
+		} else if (0 == strcmp("-o", argv[i]) && i + 1 < argc) {
+			output = argv[++i];
+		} else if ('-' != argv[i][0] && NULL == input) {
+			input = argv[i];
+		} else {
+			usage(argv);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (NULL == input) {
+		usage(argv);
+		exit(EXIT_FAILURE);
+	}
+
+	try {
+		std::string json = file_get_contents(input);
+		Json::Reader r(json);
+		Node root = readNode(r, r.next());
+		r.next();
+		if (Json::Reader::TOKEN_BEGIN_OBJECT != root.token) throw std::runtime_error("Expected an Object.");
+
+		Structs structs;
+		if (isSchema(root)) {
+			readSchema(root, structs);
+		} else {
+			readSpec(root, structs);
+		}
+
+		std::string base = output.empty() ? std::string(input) : output;
+		base = base.substr(base.find_last_of('/') + 1);
+		base = base.substr(0, base.find('.'));
+		std::string guard = "__" + identifier(base) + "_HPP__";
+		for (size_t i = 0; i < guard.length(); ++i) guard[i] = toupper(static_cast<unsigned char>(guard[i]));
+
+		std::ostringstream code;
+		generate(code, structs, ns, guard);
+
+		if (output.empty()) {
+			std::cout << code.str();
+		} else {
+			std::ofstream file(output.c_str());
+			if (!(file << code.str())) throw std::runtime_error("Could not write " + output);
+		}
+	} catch (const Json::Exception& e) {
+		std::cerr << "[!] " << input << ": " << e.what() << std::endl;
+		exit(EXIT_FAILURE);
+	} catch (const std::exception& e) {
+		std::cerr << "[!] " << input << ": " << e.what() << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	exit(EXIT_SUCCESS);
+}
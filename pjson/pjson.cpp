@@ -1,7 +1,21 @@
 #include "pjson.hpp"
 
 Json::Value
-Json::deserialize(std::string json)
+Json::deserialize(const std::string& json)
 {
-	return Json::Value(json, Json::Value::MODE_PARSE);
-};
+	Json::Reader r(json);
+	Json::Value value = r.tree();
+	r.next();
+	return value;
+}
+
+Json::Value
+Json::deserialize(std::string json, strsource source)
+{
+	std::shared_ptr<const std::string> buffer = std::make_shared<const std::string>(std::move(json));
+
+	Json::Reader r(*buffer);
+	Json::Value value = r.tree(SOURCE_KEEP == source ? buffer : std::shared_ptr<const std::string>());
+	r.next();
+	return value;
+}
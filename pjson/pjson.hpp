@@ -38,6 +38,7 @@
  * Take a look at Json::Array.
  *
  * These can be used just as you would use any normal vector in C++.
+ * A Json::Value holding an Array can also be iterated directly, see Json::Value::begin().
  * @section Example
  * @include doc-array.cpp
  * @include doc-array.out
@@ -61,7 +62,8 @@
  *
  * An object is represented in the pjson library by
  * std::map<Json::String, Json::Value>. Take a look at Json::Object.
- * All normal STL functions for this structures apply
+ * All normal STL functions for this structures apply. The members
+ * can be iterated in place through Json::Value::items().
  *
  * @section Example
  * @include doc-object.cpp
@@ -122,7 +124,8 @@
  *  - Here, we are creating a simple JSON string, which actually is the famous
  *    <a href="http://en.wikipedia.org/wiki/Fibonacci_number">fibonacci sequence</a>.
  *  - Next we utilize the deserialize function which gives us a Json::Value to work with.
- *  - Next we're using the std::for_each algorithm to print all the values.
+ *  - Next we're using a range based for loop to print all the values. The loop
+ *    iterates the array in place; nothing is copied.
  *  - Easy, no?
  *
  */
@@ -135,6 +138,14 @@
 
 #include "pjson/JsonValue.hpp"
 #include "pjson/JsonBuilder.hpp"
+#include "pjson/JsonCbor.hpp"
+#include "pjson/JsonColumns.hpp"
+#include "pjson/JsonWriter.hpp"
+#include "pjson/JsonParallel.hpp"
+#include "pjson/JsonPatch.hpp"
+#include "pjson/JsonSerializer.hpp"
+#include "pjson/JsonReader.hpp"
+#include "pjson/JsonTraits.hpp"
 #include "pjson/JsonException.hpp"
 
 namespace Json {
@@ -154,7 +165,37 @@ namespace Json {
 	 * @returns A representation of the JSON object.
 	 */
 	Json::Value
-	deserialize(std::string);
+	deserialize(const std::string&);
+
+	/**
+	 * Deserializes a JSON string, optionally keeping it with the value.
+	 *
+	 * With SOURCE_KEEP the string is moved into a buffer shared by the
+	 * returned value and everything copied from it. Each Object and
+	 * Array written without whitespace in 'json' refers to its part of
+	 * the buffer. Serializing it in minified format copies those bytes
+	 * instead of writing the Object or Array again, until it is
+	 * modified. A proxy which changes one member of a large message
+	 * thus only writes the path to that member again:
+	 * @code
+	 * Json::Value msg = Json::deserialize(std::move(body), Json::SOURCE_KEEP);
+	 * msg["route"].set("hops", Json::Builder::create(hops + 1));
+	 * forward(Json::serialize(msg, Json::FORMAT_MINIFIED));
+	 * @endcode
+	 *
+	 * The bytes are written as they were parsed: members keep their
+	 * order in 'json', and strings and numbers their spelling. Objects
+	 * and Arrays shorter than 64 bytes, or with duplicate keys, are
+	 * written again as usual. The buffer lives as long as any Object
+	 * or Array referring to it.
+	 *
+	 * @param json   The json object as a string.
+	 * @param source What to keep of 'json'.
+	 * @throws Json::Exception If the string is not valid JSON.
+	 * @returns A representation of the JSON object.
+	 */
+	Json::Value
+	deserialize(std::string json, strsource source);
 
 	/**
 	 * Serializes an object. This will give the json string
@@ -163,22 +204,207 @@ namespace Json {
 	 * but not limited to:
 	 *   - int, float, double
 	 *   - std::string
-	 *   - map<std::string, T>
-	 *   - vector<T>
+	 *   - map<std::string, T>, unordered_map<std::string, T>
+	 *   - vector<T>, array<T, N>
+	 *   - pair<T1, T2>, tuple<T...>
+	 *   - boost::optional<T>
 	 *   - bool
 	 *   - const char*
 	 *
+	 * These are written straight to the output, without building
+	 * a Json::Value first. See Json::Serializer for how to add types.
+	 *
 	 * @param object The object to serialize
 	 * @param format How to format the string
 	 * @throws Json::Exception if any error is encountered.
 	 * @return String representation of the object
 	 */
 	template <class T> std::string
-	serialize(T object, strformat format) throw (Json::Exception)
+	serialize(const T& object, strformat format) throw (Json::Exception)
 	{
-		Json::Value v = Json::Builder::create(object);
-		return v.strjson(format);
+		std::string out;
+		Json::Output::Context ctx(out, format);
+		Json::serializeTo(ctx, object);
+		return out;
 	};
+
+	/**
+	 * Serializes an object by appending it to 'out'.
+	 *
+	 * @param object The object to serialize
+	 * @param out    The string to append the serialized object to
+	 * @param format How to format the string
+	 * @throws Json::Exception if any error is encountered.
+	 * @see serialize(const T&, strformat)
+	 */
+	template <class T> void
+	serialize(const T& object, std::string& out, strformat format) throw (Json::Exception)
+	{
+		Json::Output::Context ctx(out, format);
+		Json::serializeTo(ctx, object);
+	};
+
+	/**
+	 * Serializes a Json::Value. The value is written as is,
+	 * without first being copied through Json::Builder.
+	 *
+	 * @param value  The value to serialize
+	 * @param format How to format the string
+	 * @throws Json::Exception if any error is encountered.
+	 * @return String representation of the value
+	 */
+	inline std::string
+	serialize(const Json::Value& value, strformat format) throw (Json::Exception)
+	{
+		return value.strjson(format);
+	}
+
+	/**
+	 * Serializes a Json::Value by appending it to 'out'. As the
+	 * contents of 'out' are kept, so is the memory it has reserved;
+	 * reusing one string for consecutive values avoids growing a
+	 * new buffer for each of them:
+	 * @code
+	 * std::string buffer;
+	 * for (...) {
+	 *   buffer.clear();
+	 *   Json::serialize(response, buffer, Json::FORMAT_MINIFIED);
+	 *   send(buffer);
+	 * }
+	 * @endcode
+	 *
+	 * @param value  The value to serialize
+	 * @param out    The string to append the serialized value to
+	 * @param format How to format the string
+	 * @throws Json::Exception if any error is encountered.
+	 */
+	inline void
+	serialize(const Json::Value& value, std::string& out, strformat format) throw (Json::Exception)
+	{
+		value.strjson(out, format);
+	}
+
+	/**
+	 * Serializes a Json::Value by appending it to 'out', keeping the
+	 * output of its Objects and Arrays along with them. Serializing the
+	 * value, or a copy of it, again this way copies what was kept for
+	 * each Object and Array which has not been modified since, instead
+	 * of writing it again. Modifying a member drops what was kept for
+	 * it and for every Object and Array it is in, as all of those hand
+	 * out modifiable references on the way to it; the rest is still
+	 * shared and kept for:
+	 * @code
+	 * Json::serializeMemoized(state, out, Json::FORMAT_MINIFIED);
+	 * state["players"][3].set("score", Json::Builder::create(12));
+	 * out.clear();
+	 * Json::serializeMemoized(state, out, Json::FORMAT_MINIFIED);  // Only the path to the score is written again.
+	 * @endcode
+	 *
+	 * Output between 64 bytes and 1 MB per Object or Array is kept,
+	 * once per format, for as long as the Object or Array exists.
+	 *
+	 * Nothing is kept for an Object or Array once it has handed out a
+	 * modifiable reference, as it may be modified through it at any
+	 * time; it is written every time instead, until it is next
+	 * modified through set(), erase(), push_back() or insert().
+	 * Copies of it are kept for as usual.
+	 *
+	 * @param value  The value to serialize
+	 * @param out    The string to append the serialized value to
+	 * @param format How to format the string
+	 * @throws Json::Exception if any error is encountered.
+	 */
+	inline void
+	serializeMemoized(const Json::Value& value, std::string& out, strformat format) throw (Json::Exception)
+	{
+		Json::Value::StrjsonContext ctx(out, format);
+		ctx.memoize = true;
+		value.strjson(ctx);
+	}
+
+	/**
+	 * Serializes a Json::Value into its canonical form, appending it
+	 * to 'out'. Values which are equal (see Json::Value::operator==)
+	 * have the same canonical form, and others do not, so it can be
+	 * stored or hashed in place of the value.
+	 *
+	 * The canonical form is minified, with the members of Objects in
+	 * byte order of their keys. Numbers which are integers are written
+	 * as integers, e.g. 1.0 as 1, and others in their shortest form
+	 * which reads back as the same double. Only characters which must
+	 * be escaped are. Nothing kept from parsing (see SOURCE_KEEP) is
+	 * used, and Json::RawJson fragments are parsed and written in
+	 * canonical form too.
+	 *
+	 * @param value The value to serialize
+	 * @param out   The string to append the canonical form to
+	 * @throws Json::Exception if any error is encountered.
+	 */
+	inline void
+	serializeCanonical(const Json::Value& value, std::string& out) throw (Json::Exception)
+	{
+		Json::Value::StrjsonContext ctx(out, FORMAT_MINIFIED);
+		ctx.canonical = true;
+		value.strjson(ctx);
+	}
+
+	/**
+	 * Serializes a Json::Value into its canonical form.
+	 * @see serializeCanonical(const Json::Value&, std::string&)
+	 */
+	inline std::string
+	serializeCanonical(const Json::Value& value) throw (Json::Exception)
+	{
+		std::string out;
+		Json::serializeCanonical(value, out);
+		return out;
+	}
+
+	/**
+	 * The exact number of characters Json::serialize writes for 'value'
+	 * in 'format', computed without writing anything. Useful to size a
+	 * buffer the output has to fit in, e.g. a shared memory segment.
+	 *
+	 * @param value  The value to measure.
+	 * @param format The format it would be written in.
+	 * @throws Json::Exception if any error is encountered.
+	 * @return The length of the serialized value.
+	 */
+	inline size_t
+	serializedSize(const Json::Value& value, strformat format) throw (Json::Exception)
+	{
+		return value.strjsonSize(format, 0);
+	}
+
+	/**
+	 * Serializes a Json::Value by appending it to 'out', optionally
+	 * reserving the exact size of the output first, so that 'out' is
+	 * allocated once rather than grown as the value is written.
+	 *
+	 * @param value   The value to serialize
+	 * @param out     The string to append the serialized value to
+	 * @param format  How to format the string
+	 * @param reserve How to size 'out'.
+	 * @throws Json::Exception if any error is encountered.
+	 */
+	inline void
+	serialize(const Json::Value& value, std::string& out, strformat format, strreserve reserve) throw (Json::Exception)
+	{
+		if (RESERVE_EXACT == reserve) out.reserve(out.length() + Json::serializedSize(value, format));
+		Json::serialize(value, out, format);
+	}
+
+	/**
+	 * Serializes a Json::Value into a string of its own.
+	 * @see serialize(const Json::Value&, std::string&, strformat, strreserve)
+	 */
+	inline std::string
+	serialize(const Json::Value& value, strformat format, strreserve reserve) throw (Json::Exception)
+	{
+		std::string out;
+		Json::serialize(value, out, format, reserve);
+		return out;
+	}
 }
 
 #endif
@@ -21,6 +21,8 @@ JsonBuilderSuite::run()
 	this->testMultipleArray();
 	this->testMultipleObject();
 	this->testMultipleMixed();
+
+	this->testMove();
 }
 
 void
@@ -115,6 +117,12 @@ JsonBuilderSuite::testarray()
 	Json::Value v1 = Json::Builder::create(a1);
 	for (int i = 0; i < 10; ++i) TEST_ASSERT(i, v1[i].asInt());
 
+	/* Packed whether the vector is copied or expiring. */
+	TEST_ASSERT(10u, Json::Builder::create(a1).asIntSpan().size());
+	Json::Value packed = Json::Builder::create(std::vector<int>{1, 2, 3});
+	TEST_ASSERT(3u, packed.asIntSpan().size());
+	TEST_ASSERT(Json::Int64(3), packed.asIntSpan().begin()[2]);
+
 	std::vector<std::string> a2;
 	a2.push_back("Some people never learn");
 	a2.push_back("or do they?");
@@ -265,3 +273,24 @@ JsonBuilderSuite::testMultipleMixed()
 	TEST_ASSERT(6, jv2[1]["v1m2v2"][0].asInt());
 	TEST_ASSERT(7, jv2[1]["v1m2v2"][1].asInt());
 }
+
+void
+JsonBuilderSuite::testMove()
+{
+	std::map<std::string, std::vector<std::string> > m1;
+	m1["fst"].push_back("first value");
+	m1["fst"].push_back("second value");
+	m1["snd"].push_back("third value");
+	Json::Value jv1 = Json::Builder::create(std::move(m1));
+	TEST_ASSERT("first value",  jv1["fst"][0].asString());
+	TEST_ASSERT("second value", jv1["fst"][1].asString());
+	TEST_ASSERT("third value",  jv1["snd"][0].asString());
+
+	Json::Value jv2 = Json::Builder::create(Json::value_t(std::string("moved")));
+	TEST_ASSERT(Json::JVSTRING, jv2.getType());
+	TEST_ASSERT("moved", jv2.asString());
+
+	Json::Value jv3 = Json::Builder::create(std::move(jv1));
+	TEST_ASSERT(Json::JVOBJECT, jv3.getType());
+	TEST_ASSERT("third value", jv3["snd"][0].asString());
+}
@@ -26,6 +26,8 @@ class JsonBuilderSuite
 		void testMultipleArray();
 		void testMultipleObject();
 		void testMultipleMixed();
+
+		void testMove();
 };
 
 #endif
@@ -0,0 +1,149 @@
+#include "pjtestframework.hpp"
+#include "JsonCodegenSuite.hpp"
+
+/* Generated from data/codegen-spec.json and data/codegen-schema.json by ../jsoncodegen. */
+#include "CodegenSpec.hpp"
+#include "CodegenSchema.hpp"
+
+static const char *show =
+	"{"
+	"  \"name\"        : \"The walking dead\","
+	"  \"rating\"      : 8.5,"
+	"  \"zombies\"     : true,"
+	"  \"episodes\"    : [ { \"name\" : \"Days Gone Bye\", \"minutes\" : 67, \"aired\" : 1288483200 },"
+	"                    { \"name\" : \"Guts\", \"minutes\" : 44, \"aired\" : null } ],"
+	"  \"network\"     : \"AMC\","
+	"  \"seasons\"     : { \"1\" : 6, \"2\" : 13 },"
+	"  \"first-aired\" : 18446744073709551615,"
+	"  \"extra\"       : { \"k\" : [true, null] },"
+	"  \"tags\"        : [ \"horror\", \"drama\" ],"
+	"  \"title\"       : \"TWD\","
+	"  \"season\"      : 2,"
+	"  \"series\"      : \"main\""
+	"}";
+
+void
+JsonCodegenSuite::run()
+{
+	std::cout << "Running suite 'JsonCodegen'.";
+
+	this->specRead();
+	this->specOrder();
+	this->specWrite();
+	this->specInvalid();
+	this->specKeywords();
+	this->schema();
+}
+
+void
+JsonCodegenSuite::report()
+{
+	std::cout << pjreport();
+}
+
+void
+JsonCodegenSuite::specRead()
+{
+	codegen::spec::Show s = Json::deserializeInto<codegen::spec::Show>(show);
+
+	TEST_ASSERT("The walking dead", s.name);
+	TEST_ASSERT(8.5, s.rating);
+	TEST_ASSERT(true, s.zombies);
+	TEST_ASSERT(2u, s.episodes.size());
+	TEST_ASSERT("Days Gone Bye", s.episodes[0].name);
+	TEST_ASSERT(67, s.episodes[0].minutes);
+	TEST_ASSERT(1288483200, *s.episodes[0].aired);
+	TEST_ASSERT(false, static_cast<bool>(s.episodes[1].aired));
+	TEST_ASSERT("AMC", *s.network);
+	TEST_ASSERT(13, s.seasons["2"]);
+	TEST_ASSERT(18446744073709551615ULL, s.first_aired);
+	TEST_ASSERT(true, s.extra["k"][0].asBool());
+	TEST_ASSERT("drama", s.tags[1]);
+	TEST_ASSERT("TWD", s.title);
+	TEST_ASSERT(2, s.season);
+	TEST_ASSERT("main", s.series);
+}
+
+void
+JsonCodegenSuite::specOrder()
+{
+	/* Out of order, escaped and unknown keys all go through the lookup. */
+	codegen::spec::Show s = Json::deserializeInto<codegen::spec::Show>(
+		"{ \"series\" : \"b\", \"seasonal\" : [1, {\"season\" : 3}], \"season\" : 4,"
+		"  \"ser\\u0069es\" : \"c\", \"\" : 1, \"title\" : \"t\", \"name\" : \"n\" }");
+
+	TEST_ASSERT("c", s.series);
+	TEST_ASSERT(4, s.season);
+	TEST_ASSERT("t", s.title);
+	TEST_ASSERT("n", s.name);
+	TEST_ASSERT(0, s.rating);
+	TEST_ASSERT(true, s.episodes.empty());
+}
+
+void
+JsonCodegenSuite::specWrite()
+{
+	codegen::spec::Show s = Json::deserializeInto<codegen::spec::Show>(show);
+
+	/* Written in declaration order, so compare through Json::Value for the pretty format. */
+	TEST_ASSERT(Json::serialize(Json::deserialize(show), Json::FORMAT_PRETTY),
+	            Json::serialize(Json::deserialize(Json::serialize(s, Json::FORMAT_PRETTY)), Json::FORMAT_PRETTY));
+
+	codegen::spec::Episode e;
+	e.name    = "Guts";
+	e.minutes = 44;
+	TEST_ASSERT("{\"name\":\"Guts\",\"minutes\":44,\"aired\":null}", Json::serialize(e, Json::FORMAT_MINIFIED));
+	TEST_ASSERT("{\n\t\"name\" : \"Guts\",\n\t\"minutes\" : 44,\n\t\"aired\" : null\n}", Json::serialize(e, Json::FORMAT_PRETTY));
+}
+
+void
+JsonCodegenSuite::specInvalid()
+{
+	TEST_THROWS(Json::deserializeInto<codegen::spec::Episode>("[]"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<codegen::spec::Episode>("{ \"minutes\" : \"long\" }"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<codegen::spec::Episode>("{ \"name\" : \"a\", }"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<codegen::spec::Show>("{ \"episodes\" : [ { \"aired\" : 1.5 } ] }"), Json::Exception);
+}
+
+void
+JsonCodegenSuite::specKeywords()
+{
+	/* Members which can not be named after their key get a trailing '_'. */
+	codegen::spec::Keywords k = Json::deserializeInto<codegen::spec::Keywords>(
+		"{ \"class\" : \"c\", \"default\" : 3, \"Keywords\" : true, \"a-b\" : 4 }");
+
+	TEST_ASSERT("c", k.class_);
+	TEST_ASSERT(3, k.default_);
+	TEST_ASSERT(true, k.Keywords_);
+	TEST_ASSERT(4, k.a_b);
+	TEST_ASSERT("{\"class\":\"c\",\"default\":3,\"Keywords\":true,\"a-b\":4}", Json::serialize(k, Json::FORMAT_MINIFIED));
+}
+
+void
+JsonCodegenSuite::schema()
+{
+	Order o = Json::deserializeInto<Order>(
+		"{ \"id\" : 7, \"items\" : [ { \"sku\" : \"A-1\", \"quantity\" : 2, \"price\" : 9.5 },"
+		"                          { \"sku\" : \"B-2\", \"quantity\" : 1 } ],"
+		"  \"customer\" : { \"name\" : \"Bob\", \"email\" : null },"
+		"  \"meta\" : { \"weight\" : 1.25 }, \"note\" : [\"x\"], \"total\" : { \"amount\" : 21.5 } }");
+
+	TEST_ASSERT(7, o.id);
+	TEST_ASSERT(2u, o.items.size());
+	TEST_ASSERT("A-1", o.items[0].sku);
+	TEST_ASSERT(9.5, *o.items[0].price);
+	TEST_ASSERT(false, static_cast<bool>(o.items[1].price));
+	TEST_ASSERT("Bob", o.customer->name);
+	TEST_ASSERT(false, static_cast<bool>(o.customer->email));
+	TEST_ASSERT(false, static_cast<bool>(o.paid));
+	TEST_ASSERT(1.25, (*o.meta)["weight"]);
+	TEST_ASSERT("x", o.note[0].asString());
+
+	/* A struct may be named like a class of namespace Json. */
+	TEST_ASSERT(21.5, *o.total->amount);
+
+	TEST_ASSERT("{\"id\":7,\"items\":[{\"sku\":\"A-1\",\"quantity\":2,\"price\":9.5},{\"sku\":\"B-2\",\"quantity\":1,\"price\":null}],"
+	            "\"customer\":{\"name\":\"Bob\",\"email\":null},\"paid\":null,\"meta\":{\"weight\":1.25},\"note\":[\"x\"],"
+	            "\"total\":{\"amount\":21.5}}",
+	            Json::serialize(o, Json::FORMAT_MINIFIED));
+}
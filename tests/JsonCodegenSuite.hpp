@@ -0,0 +1,26 @@
+#ifndef __JSONCODEGENSUITE_HPP__
+#define __JSONCODEGENSUITE_HPP__
+
+#include <pjson/pjson.hpp>
+#include <vector>
+#include <string>
+#include <iostream>
+
+class JsonCodegenSuite
+{
+	public:
+		JsonCodegenSuite() {};
+
+		void run();
+		void report();
+
+	private:
+		void specRead();
+		void specOrder();
+		void specWrite();
+		void specInvalid();
+		void specKeywords();
+		void schema();
+};
+
+#endif
@@ -0,0 +1,202 @@
+#include "pjtestframework.hpp"
+#include "JsonReaderSuite.hpp"
+
+struct Episode
+{
+	std::string name;
+	int         minutes;
+};
+
+struct Show
+{
+	std::string                   name;
+	double                        rating;
+	bool                          zombies;
+	std::vector<Episode>          episodes;
+	boost::optional<std::string>  network;
+	std::map<std::string, int>    seasons;
+	Json::Value                   extra;
+};
+
+JSON_TRAITS(Episode, name, minutes)
+JSON_TRAITS(Show, name, rating, zombies, episodes, network, seasons, extra)
+
+void
+JsonReaderSuite::run()
+{
+	std::cout << "Running suite 'JsonReader'.";
+
+	this->tokens();
+	this->skip();
+	this->invalid();
+	this->typed();
+	this->typedStructs();
+	this->typedInvalid();
+}
+
+void
+JsonReaderSuite::report()
+{
+	std::cout << pjreport();
+}
+
+void
+JsonReaderSuite::tokens()
+{
+	Json::Reader r(" { \"a\\n\" : [1, -2.5e1, \"x\\u00e9\"], \"b\" : { }, \"c\" : [true, null] } ");
+
+	TEST_ASSERT(Json::Reader::TOKEN_BEGIN_OBJECT, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_KEY, r.next());
+	TEST_ASSERT("a\n", std::string(r.string()));
+	TEST_ASSERT(Json::Reader::TOKEN_BEGIN_ARRAY, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_NUMBER, r.next());
+	TEST_ASSERT(true, r.isInteger());
+	TEST_ASSERT(1, r.int64());
+	TEST_ASSERT(Json::Reader::TOKEN_NUMBER, r.next());
+	TEST_ASSERT(false, r.isInteger());
+	TEST_ASSERT(-25.0, r.number());
+	TEST_ASSERT("-2.5e1", std::string(r.raw()));
+	TEST_ASSERT(Json::Reader::TOKEN_STRING, r.peek());
+	TEST_ASSERT(Json::Reader::TOKEN_STRING, r.next());
+	TEST_ASSERT("x\xc3\xa9", std::string(r.string()));
+	TEST_ASSERT(Json::Reader::TOKEN_END_ARRAY, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_KEY, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_BEGIN_OBJECT, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_END_OBJECT, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_KEY, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_BEGIN_ARRAY, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_BOOL, r.next());
+	TEST_ASSERT(true, r.boolean());
+	TEST_ASSERT(Json::Reader::TOKEN_NULL, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_END_ARRAY, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_END_OBJECT, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_END, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_END, r.next());
+}
+
+void
+JsonReaderSuite::skip()
+{
+	Json::Reader r("[{ \"a\" : [1, { \"b\" : \"]}\" }] }, 2]");
+
+	TEST_ASSERT(Json::Reader::TOKEN_BEGIN_ARRAY, r.next());
+	r.skip();
+	TEST_ASSERT(Json::Reader::TOKEN_NUMBER, r.next());
+	TEST_ASSERT(2, r.int64());
+	TEST_ASSERT(Json::Reader::TOKEN_END_ARRAY, r.next());
+	TEST_ASSERT(Json::Reader::TOKEN_END, r.next());
+}
+
+static void
+readAll(const char *json)
+{
+	Json::Reader r(json);
+	while (Json::Reader::TOKEN_END != r.next());
+}
+
+void
+JsonReaderSuite::invalid()
+{
+	TEST_THROWS(readAll(""), Json::Exception);
+	TEST_THROWS(readAll("[1, 2"), Json::Exception);
+	TEST_THROWS(readAll("[1, 2,]"), Json::Exception);
+	TEST_THROWS(readAll("[1 2]"), Json::Exception);
+	TEST_THROWS(readAll("{ \"a\" }"), Json::Exception);
+	TEST_THROWS(readAll("{ 1 : 2 }"), Json::Exception);
+	TEST_THROWS(readAll("[1}"), Json::Exception);
+	TEST_THROWS(readAll("[01]"), Json::Exception);
+	TEST_THROWS(readAll("[1.]"), Json::Exception);
+	TEST_THROWS(readAll("[tru]"), Json::Exception);
+	TEST_THROWS(readAll("[\"abc]"), Json::Exception);
+	TEST_THROWS(readAll("[\"a\\x\"]"), Json::Exception);
+	TEST_THROWS(readAll("[] []"), Json::Exception);
+}
+
+void
+JsonReaderSuite::typed()
+{
+	TEST_ASSERT(42, Json::deserializeInto<int>(" 42 "));
+	TEST_ASSERT(-1.5, Json::deserializeInto<double>("-1.5"));
+	TEST_ASSERT(true, Json::deserializeInto<bool>("true"));
+	TEST_ASSERT("a\"b", Json::deserializeInto<std::string>("\"a\\\"b\""));
+	TEST_ASSERT(18446744073709551615ULL, Json::deserializeInto<uint64_t>("18446744073709551615"));
+
+	std::vector<int> v = Json::deserializeInto<std::vector<int> >("[1, 2, 3]");
+	TEST_ASSERT(3u, v.size());
+	TEST_ASSERT(3, v[2]);
+
+	std::map<std::string, std::vector<std::string> > m;
+	Json::deserializeInto("{ \"a\" : [\"x\"], \"b\" : [] }", m);
+	TEST_ASSERT(2u, m.size());
+	TEST_ASSERT("x", m["a"][0]);
+	TEST_ASSERT(true, m["b"].empty());
+
+	boost::optional<int> o = Json::deserializeInto<boost::optional<int> >("null");
+	TEST_ASSERT(false, static_cast<bool>(o));
+	o = Json::deserializeInto<boost::optional<int> >("7");
+	TEST_ASSERT(7, *o);
+
+	Json::Value value = Json::deserializeInto<Json::Value>("{ \"a\" : [1, 2.5, \"s\", null, -9223372036854775808] }");
+	TEST_ASSERT("{\"a\":[1,2.5,\"s\",null,-9223372036854775808]}", Json::serialize(value, Json::FORMAT_MINIFIED));
+}
+
+void
+JsonReaderSuite::typedStructs()
+{
+	const char *json =
+		"{"
+		"  \"name\"     : \"The walking dead\","
+		"  \"unknown\"  : { \"skipped\" : [1, 2, { \"a\" : null }] },"
+		"  \"rating\"   : 8.5,"
+		"  \"zombies\"  : true,"
+		"  \"episodes\" : [ { \"name\" : \"Days Gone Bye\", \"minutes\" : 67, \"aired\" : 2010 },"
+		"                   { \"name\" : \"Guts\", \"minutes\" : 44 } ],"
+		"  \"network\"  : null,"
+		"  \"seasons\"  : { \"1\" : 6, \"2\" : 13 },"
+		"  \"extra\"    : { \"k\" : [true] }"
+		"}";
+
+	Show show = Json::deserializeInto<Show>(json);
+	TEST_ASSERT("The walking dead", show.name);
+	TEST_ASSERT(8.5, show.rating);
+	TEST_ASSERT(true, show.zombies);
+	TEST_ASSERT(2u, show.episodes.size());
+	TEST_ASSERT("Days Gone Bye", show.episodes[0].name);
+	TEST_ASSERT(67, show.episodes[0].minutes);
+	TEST_ASSERT("Guts", show.episodes[1].name);
+	TEST_ASSERT(false, static_cast<bool>(show.network));
+	TEST_ASSERT(13, show.seasons["2"]);
+	TEST_ASSERT(true, show.extra["k"][0].asBool());
+
+	/* Fields missing from the input keep their values. */
+	Episode episode;
+	episode.name    = "Pilot";
+	episode.minutes = 30;
+	Json::deserializeInto("{ \"minutes\" : 45 }", episode);
+	TEST_ASSERT("Pilot", episode.name);
+	TEST_ASSERT(45, episode.minutes);
+
+	/* The same traits write the struct back. */
+	TEST_ASSERT("{\"name\":\"Pilot\",\"minutes\":45}", Json::serialize(episode, Json::FORMAT_MINIFIED));
+	TEST_ASSERT(Json::serialize(Json::deserialize(Json::serialize(show, Json::FORMAT_PRETTY)), Json::FORMAT_MINIFIED),
+	            Json::serialize(Json::deserialize("{ \"name\" : \"The walking dead\", \"rating\" : 8.5, \"zombies\" : true,"
+	                              "  \"episodes\" : [ { \"name\" : \"Days Gone Bye\", \"minutes\" : 67 },"
+	                              "                   { \"name\" : \"Guts\", \"minutes\" : 44 } ],"
+	                              "  \"network\" : null, \"seasons\" : { \"1\" : 6, \"2\" : 13 },"
+	                              "  \"extra\" : { \"k\" : [true] } }"), Json::FORMAT_MINIFIED));
+}
+
+void
+JsonReaderSuite::typedInvalid()
+{
+	TEST_THROWS(Json::deserializeInto<int>("\"1\""), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<int>("1.5"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<int>("2147483648"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<unsigned int>("-1"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<std::string>("null"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<std::vector<int> >("{}"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<Episode>("[]"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<Episode>("{ \"minutes\" : \"long\" }"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<Episode>("{ \"minutes\" : 1 } 2"), Json::Exception);
+	TEST_THROWS(Json::deserializeInto<Episode>("{ \"minutes\" : 1"), Json::Exception);
+}
@@ -0,0 +1,26 @@
+#ifndef __JSONREADERSUITE_HPP__
+#define __JSONREADERSUITE_HPP__
+
+#include <pjson/pjson.hpp>
+#include <vector>
+#include <string>
+#include <iostream>
+
+class JsonReaderSuite
+{
+	public:
+		JsonReaderSuite() {};
+
+		void run();
+		void report();
+
+	private:
+		void tokens();
+		void skip();
+		void invalid();
+		void typed();
+		void typedStructs();
+		void typedInvalid();
+};
+
+#endif
@@ -2,6 +2,14 @@
 #include "JsonStringSuite.hpp"
 
 #include <pjson/pjson.hpp>
+#include <limits>
+#include <thread>
+#include <array>
+#include <tuple>
+#include <unordered_map>
+#include <boost/optional.hpp>
+#include <cstdio>
+#include <unistd.h>
 
 void
 JsonStringSuite::run()
@@ -18,6 +26,15 @@ JsonStringSuite::run()
 	this->deepArray();
 	this->deepObject();
 	this->mixed();
+	this->minified();
+	this->appending();
+	this->concurrent();
+	this->containers();
+	this->parallel();
+	this->sizes();
+	this->memoized();
+	this->passthrough();
+	this->raw();
 }
 
 void
@@ -34,6 +51,20 @@ JsonStringSuite::stringstring()
 
 	std::string ser2 = Json::serialize(std::string("[Stuff with \" say \\  \" \"{"), Json::FORMAT_PRETTY);
 	TEST_ASSERT("\"[Stuff with \\\" say \\\\  \\\" \\\"{\"", ser2);
+
+	std::string ser3 = Json::serialize(std::string("tab\tnewline\n\x01\x1f end"), Json::FORMAT_PRETTY);
+	TEST_ASSERT("\"tab\\tnewline\\n\\u0001\\u001f end\"", ser3);
+
+	/* Escapes on both sides of the 16 character blocks, and after them. */
+	std::string long1(40, 'x');
+	long1[0] = '"'; long1[15] = '\\'; long1[16] = '\n'; long1[39] = '\r';
+	std::string ser4 = Json::serialize(long1, Json::FORMAT_PRETTY);
+	TEST_ASSERT("\"\\\"" + std::string(14, 'x') + "\\\\\\n" + std::string(22, 'x') + "\\r\"", ser4);
+	TEST_ASSERT(long1, Json::deserialize(ser4).asString());
+
+	std::string utf8("caf\xc3\xa9 \xf0\x9f\x98\x80");
+	TEST_ASSERT("\"" + utf8 + "\"", Json::serialize(utf8, Json::FORMAT_PRETTY));
+	TEST_ASSERT(utf8, Json::deserialize("\"caf\\u00e9 \\ud83d\\ude00\"").asString());
 }
 
 void
@@ -64,6 +95,24 @@ JsonStringSuite::stringnumber()
 
 	std::string ser3 = Json::serialize(42e2, Json::FORMAT_PRETTY);
 	TEST_ASSERT("4200", ser3);
+
+	/* The shortest digits which read back as the same double. */
+	TEST_ASSERT("0.1",     Json::serialize(0.1, Json::FORMAT_PRETTY));
+	TEST_ASSERT("-0.0674", Json::serialize(-0.0674, Json::FORMAT_PRETTY));
+	TEST_ASSERT("0.000001", Json::serialize(1e-6, Json::FORMAT_PRETTY));
+	TEST_ASSERT("1e-7",    Json::serialize(1e-7, Json::FORMAT_PRETTY));
+	TEST_ASSERT("1e+21",   Json::serialize(1e21, Json::FORMAT_PRETTY));
+	TEST_ASSERT("1.7976931348623157e+308", Json::serialize(1.7976931348623157e308, Json::FORMAT_PRETTY));
+	TEST_ASSERT("5e-324",  Json::serialize(5e-324, Json::FORMAT_PRETTY));
+	TEST_ASSERT("null",    Json::serialize(std::numeric_limits<double>::quiet_NaN(), Json::FORMAT_PRETTY));
+
+	TEST_ASSERT("-2147483648", Json::serialize(std::numeric_limits<int>::min(), Json::FORMAT_PRETTY));
+	TEST_ASSERT("0",           Json::serialize(0, Json::FORMAT_PRETTY));
+
+	double d = 0.1 + 0.2;
+	std::string ser4 = Json::serialize(d, Json::FORMAT_PRETTY);
+	TEST_ASSERT("0.30000000000000004", ser4);
+	TEST_ASSERT(d, Json::deserialize(ser4).asNumber());
 }
 
 void
@@ -222,3 +271,359 @@ JsonStringSuite::mixed()
 	std::string exp = readfile("data/strjson/mixed1.json");
 	TEST_ASSERT(exp, ser);
 }
+
+void
+JsonStringSuite::minified()
+{
+	std::string exp = readfile("data/strjson/mixed1.json");
+	Json::Value v = Json::deserialize(exp);
+	TEST_ASSERT(Json::Value::minify(exp), Json::serialize(v, Json::FORMAT_MINIFIED));
+	TEST_ASSERT(exp, Json::serialize(v, Json::FORMAT_PRETTY));
+
+	/* Whitespace in strings is kept, also after an escaped quote. */
+	std::vector<std::string> words;
+	words.push_back("say \"hi\" ");
+	words.push_back(" to me");
+	TEST_ASSERT("[\"say \\\"hi\\\" \",\" to me\"]", Json::serialize(words, Json::FORMAT_MINIFIED));
+
+	TEST_ASSERT("{}", Json::serialize(Json::deserialize("{}"), Json::FORMAT_MINIFIED));
+	TEST_ASSERT("[1,2.5]", Json::serialize(Json::deserialize("[1, 2.5]"), Json::FORMAT_MINIFIED));
+}
+
+void
+JsonStringSuite::appending()
+{
+	Json::Value v = Json::deserialize("{ \"a\" : [1, 2], \"b\" : \"c\" }");
+
+	std::string buffer("prefix ");
+	Json::serialize(v, buffer, Json::FORMAT_MINIFIED);
+	TEST_ASSERT("prefix {\"a\":[1,2],\"b\":\"c\"}", buffer);
+
+	buffer.clear();
+	size_t capacity = buffer.capacity();
+	Json::serialize(v, buffer, Json::FORMAT_MINIFIED);
+	TEST_ASSERT(capacity, buffer.capacity());
+	TEST_ASSERT(Json::serialize(v, Json::FORMAT_MINIFIED), buffer);
+}
+
+void
+JsonStringSuite::concurrent()
+{
+	/* Differently nested documents, so any shared indentation shows. */
+	std::vector<Json::Value> docs;
+	docs.push_back(Json::deserialize(readfile("data/strjson/mixed1.json")));
+	docs.push_back(Json::deserialize("[[[[1, [2]], 3]], { \"a\" : { \"b\" : [4] } }]"));
+	docs.push_back(Json::deserialize("{ \"x\" : [true, false, null] }"));
+
+	std::vector<std::string> expected;
+	for (const Json::Value& doc : docs) {
+		expected.push_back(Json::serialize(doc, Json::FORMAT_PRETTY));
+	}
+
+	std::vector<int> mismatches(docs.size() * 2, 0);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < mismatches.size(); ++t) {
+		threads.push_back(std::thread([&, t]() {
+			size_t d = t % docs.size();
+			for (int i = 0; i < 500; ++i) {
+				if (expected[d] != Json::serialize(docs[d], Json::FORMAT_PRETTY)) mismatches[t]++;
+			}
+		}));
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	for (size_t t = 0; t < mismatches.size(); ++t) {
+		TEST_ASSERT(0, mismatches[t]);
+	}
+}
+
+void
+JsonStringSuite::containers()
+{
+	/* Written directly, the output matches that of the built Json::Value. */
+	std::map<std::string, std::vector<double> > m1;
+	m1["a"].push_back(1.5);
+	m1["a"].push_back(-2);
+	m1["b"];
+	m1["c"].push_back(1e300);
+	TEST_ASSERT(Json::serialize(Json::Builder::create(m1), Json::FORMAT_PRETTY),
+	            Json::serialize(m1, Json::FORMAT_PRETTY));
+	TEST_ASSERT("{\"a\":[1.5,-2],\"b\":[],\"c\":[1e+300]}", Json::serialize(m1, Json::FORMAT_MINIFIED));
+
+	std::unordered_map<std::string, bool> m2;
+	m2["only"] = true;
+	TEST_ASSERT("{\"only\":true}", Json::serialize(m2, Json::FORMAT_MINIFIED));
+
+	std::array<int, 3> a1 = {{ 1, 2, 3 }};
+	TEST_ASSERT("[1,2,3]", Json::serialize(a1, Json::FORMAT_MINIFIED));
+
+	std::pair<std::string, unsigned long long> p1("big", 18446744073709551615ULL);
+	TEST_ASSERT("[\"big\",18446744073709551615]", Json::serialize(p1, Json::FORMAT_MINIFIED));
+
+	std::tuple<int, const char*, bool, float> t1(1, "two", false, 0.5f);
+	TEST_ASSERT("[1,\"two\",false,0.5]", Json::serialize(t1, Json::FORMAT_MINIFIED));
+	TEST_ASSERT("[\n\t1,\n\t\"two\",\n\tfalse,\n\t0.5\n]", Json::serialize(t1, Json::FORMAT_PRETTY));
+
+	std::vector<boost::optional<int> > o1(2);
+	o1[1] = 7;
+	TEST_ASSERT("[null,7]", Json::serialize(o1, Json::FORMAT_MINIFIED));
+
+	TEST_ASSERT("\"literal\"", Json::serialize("literal", Json::FORMAT_MINIFIED));
+
+	std::string out("[");
+	Json::serialize(a1, out, Json::FORMAT_MINIFIED);
+	TEST_ASSERT("[[1,2,3]", out);
+}
+
+void
+JsonStringSuite::parallel()
+{
+	/* Large Arrays and Objects, nested in each other and among small values. */
+	Json::Object rows;
+	for (int i = 0; i < 3000; ++i) {
+		Json::Object row;
+		row["id"]   = Json::Builder::create(i);
+		row["name"] = Json::Builder::create("row \"" + std::to_string(i) + "\"");
+		row["tags"] = Json::Builder::create(std::vector<std::string>(i % 3, "t"));
+		rows["row" + std::to_string(i)] = Json::Builder::create(Json::value_t(std::move(row)));
+	}
+
+	Json::Array nested;
+	for (int i = 0; i < 2500; ++i) {
+		nested.push_back(0 == i % 500 ? Json::Builder::create(std::vector<int>(1500, i))
+		                              : Json::Builder::create(i * 0.5));
+	}
+
+	Json::Object doc;
+	doc["a"]       = Json::Builder::create(true);
+	doc["doubles"] = Json::Builder::create(std::vector<double>(10000, 0.1));
+	doc["ints"]    = Json::Builder::create(std::vector<int64_t>(5000, -7));
+	doc["nested"]  = Json::Builder::create(Json::value_t(std::move(nested)));
+	doc["rows"]    = Json::Builder::create(Json::value_t(std::move(rows)));
+	doc["z"]       = Json::Builder::create("last");
+	Json::Value v = Json::Builder::create(Json::value_t(std::move(doc)));
+
+	Json::ThreadPool one(1), four(4);
+	const Json::strformat formats[] = { Json::FORMAT_MINIFIED, Json::FORMAT_PRETTY };
+	for (size_t i = 0; i < 2; ++i) {
+		std::string expected = Json::serialize(v, formats[i]);
+
+		std::string out("prefix");
+		Json::serialize(v, out, formats[i], four);
+		TEST_ASSERT("prefix" + expected, out);
+
+		out.clear();
+		Json::serialize(v, out, formats[i], one);
+		TEST_ASSERT(expected, out);
+
+		/* Through writev() to a file. */
+		FILE *tmp = tmpfile();
+		Json::serialize(v, fileno(tmp), formats[i], four);
+		std::string written(expected.size() + 1, '\0');
+		rewind(tmp);
+		written.resize(fread(&written[0], 1, written.size(), tmp));
+		fclose(tmp);
+		TEST_ASSERT(expected, written);
+	}
+
+	/* Small values are written as they are. */
+	std::string small;
+	Json::serialize(Json::deserialize("{ \"a\" : [1, 2] }"), small, Json::FORMAT_MINIFIED, four);
+	TEST_ASSERT("{\"a\":[1,2]}", small);
+
+	/* One pool serves serializations from several threads at once. */
+	std::vector<std::string> outs(4);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < outs.size(); ++i) {
+		threads.push_back(std::thread([&v, &outs, &four, i] {
+			Json::serialize(v, outs[i], Json::FORMAT_MINIFIED, four);
+		}));
+	}
+	for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+	for (size_t i = 0; i < outs.size(); ++i) TEST_ASSERT(Json::serialize(v, Json::FORMAT_MINIFIED), outs[i]);
+
+	TEST_THROWS(Json::serialize(v, -1, Json::FORMAT_MINIFIED, four), Json::Exception);
+}
+
+void
+JsonStringSuite::sizes()
+{
+	const char *docs[] = {
+		"null", "true", "false", "0", "-9223372036854775808", "18446744073709551615", "1.5e+300", "0.001",
+		"\"\"", "\"a\\\"b\\\\c\\n\\u0001\\u001f\\u00e9/\"",
+		"{}", "[]", "[[]]", "[{}, {}]", "[1, 2, 3]", "[1.5, 2, -3.25]",
+		"{ \"a\" : { \"b\" : [1, { \"c\" : [true, null, \"x\"] }, []], \"d\" : {} }, \"e\\t\" : -0.5 }"
+	};
+
+	const Json::strformat formats[] = { Json::FORMAT_MINIFIED, Json::FORMAT_PRETTY };
+	for (size_t i = 0; i < sizeof(docs) / sizeof(docs[0]); ++i) {
+		Json::Value v = Json::deserialize(docs[i]);
+		for (size_t f = 0; f < 2; ++f) {
+			TEST_ASSERT(Json::serialize(v, formats[f]).length(), Json::serializedSize(v, formats[f]));
+		}
+	}
+
+	Json::Value big = Json::Builder::create(std::vector<double>(1000, 1.0 / 3));
+	std::string out("x");
+	Json::serialize(big, out, Json::FORMAT_PRETTY, Json::RESERVE_EXACT);
+	TEST_ASSERT("x" + Json::serialize(big, Json::FORMAT_PRETTY), out);
+	TEST_ASSERT(out.length(), 1 + Json::serializedSize(big, Json::FORMAT_PRETTY));
+	TEST_ASSERT(true, out.capacity() >= out.length());
+	TEST_ASSERT(Json::serialize(big, Json::FORMAT_MINIFIED), Json::serialize(big, Json::FORMAT_MINIFIED, Json::RESERVE_EXACT));
+}
+
+static std::string
+serializeMemoized(const Json::Value& v, Json::strformat format)
+{
+	std::string out;
+	Json::serializeMemoized(v, out, format);
+	return out;
+}
+
+void
+JsonStringSuite::memoized()
+{
+	Json::Value players = Json::Builder::create(Json::value_t(Json::Array()));
+	for (int i = 0; i < 50; ++i) {
+		Json::Value player = Json::Builder::create(Json::value_t(Json::Object()));
+		player.set("name", Json::Builder::create("player " + std::to_string(i)));
+		player.set("scores", Json::Builder::create(std::vector<int>(40, i)));
+		player.set("position", Json::Builder::create(std::vector<double>(30, i + 0.25)));
+		players.push_back(std::move(player));
+	}
+
+	Json::Value state = Json::Builder::create(Json::value_t(Json::Object()));
+	state.set("players", players);
+	state.set("round", Json::Builder::create(1));
+
+	const Json::strformat formats[] = { Json::FORMAT_MINIFIED, Json::FORMAT_PRETTY };
+	for (size_t f = 0; f < 2; ++f) {
+		Json::Value v = state;
+
+		TEST_ASSERT(Json::serialize(v, formats[f]), serializeMemoized(v, formats[f]));
+		TEST_ASSERT(Json::serialize(v, formats[f]), serializeMemoized(v, formats[f]));
+
+		/* Modifications deep down are seen, as is what was kept for the rest. */
+		v["players"][3].set("name", Json::Builder::create("renamed"));
+		v["players"][7]["scores"][0] = Json::Builder::create(-1);
+		v.set("round", Json::Builder::create(2));
+		std::string out = serializeMemoized(v, formats[f]);
+		TEST_ASSERT(Json::serialize(v, formats[f]), out);
+		TEST_ASSERT(true, std::string::npos != out.find("renamed"));
+		TEST_ASSERT(true, std::string::npos != out.find("-1"));
+
+		/* Copies share what was kept, but not the modifications made to them. */
+		Json::Value copy = v;
+		copy["players"][3].erase("scores");
+		TEST_ASSERT(Json::serialize(copy, formats[f]), serializeMemoized(copy, formats[f]));
+		TEST_ASSERT(Json::serialize(v, formats[f]), serializeMemoized(v, formats[f]));
+		TEST_ASSERT(true, serializeMemoized(v, formats[f]) != serializeMemoized(copy, formats[f]));
+
+		/* The same Object at another depth is written at that depth. */
+		Json::Value nested = Json::Builder::create(Json::value_t(Json::Object()));
+		nested.set("deeper", v["players"]);
+		nested.set("same", v["players"]);
+		TEST_ASSERT(Json::serialize(nested, formats[f]), serializeMemoized(nested, formats[f]));
+	}
+}
+
+void
+JsonStringSuite::passthrough()
+{
+	/* Not in key order, and spelled differently than it would be written. */
+	std::string route  = "{\"to\":\"caf\\u00e9\",\"hops\":3,\"via\":[1.50,2E2,\"\\/gateway\",true,null]}";
+	std::string body   = "[10,20,30,40,50,60,70,80,90,100,110,120,130,140,150,160,170,180,190,200]";
+	std::string json   = "{\"route\":" + route + ",\"body\":" + body + ",\"id\":\"m1\"}";
+
+	Json::Value msg = Json::deserialize(json, Json::SOURCE_KEEP);
+	TEST_ASSERT(json, Json::serialize(msg, Json::FORMAT_MINIFIED));
+	TEST_ASSERT(json.length(), Json::serializedSize(msg, Json::FORMAT_MINIFIED));
+	TEST_ASSERT(Json::serialize(Json::deserialize(json), Json::FORMAT_PRETTY),
+	            Json::serialize(msg, Json::FORMAT_PRETTY));
+	TEST_ASSERT(Json::serialize(Json::deserialize(json), Json::FORMAT_MINIFIED),
+	            Json::serialize(Json::deserialize(json, Json::SOURCE_DISCARD), Json::FORMAT_MINIFIED));
+
+	/* Modified Objects are written again; what is left untouched is not. */
+	Json::Value copy = msg;
+	copy.set("id", Json::Builder::create("m2"));
+	std::string out = Json::serialize(copy, Json::FORMAT_MINIFIED);
+	TEST_ASSERT("{\"body\":" + body + ",\"id\":\"m2\",\"route\":" + route + "}", out);
+	TEST_ASSERT(out.length(), Json::serializedSize(copy, Json::FORMAT_MINIFIED));
+	TEST_ASSERT(json, Json::serialize(msg, Json::FORMAT_MINIFIED));
+
+	copy["route"].set("hops", Json::Builder::create(4));
+	out = Json::serialize(copy, Json::FORMAT_MINIFIED);
+	TEST_ASSERT(true, std::string::npos == out.find(route));
+	TEST_ASSERT(true, std::string::npos != out.find("\"hops\":4"));
+	TEST_ASSERT(true, std::string::npos != out.find(body));
+
+	/* Members outlive the document, and the buffer they refer to with them. */
+	Json::Value via = Json::Builder::create(Json::value_t(Json::Array()));
+	{
+		Json::Value doc = Json::deserialize("[" + body + "," + route + "]", Json::SOURCE_KEEP);
+		via = doc[1];
+	}
+	TEST_ASSERT(route, Json::serialize(via, Json::FORMAT_MINIFIED));
+
+	/* Objects and Arrays with whitespace, and their parents, are written again. */
+	Json::Value spaced = Json::deserialize("{\"route\":" + route + ",\"body\": " + body + "}", Json::SOURCE_KEEP);
+	out = Json::serialize(spaced, Json::FORMAT_MINIFIED);
+	TEST_ASSERT(true, std::string::npos != out.find(route));
+	TEST_ASSERT(true, std::string::npos != out.find("\"body\":[10,20"));
+
+	/* As are Objects with duplicate keys. */
+	std::string twice = "{\"id\":1,\"route\":" + route + ",\"id\":2}";
+	TEST_ASSERT("{\"id\":2,\"route\":" + route + "}",
+	            Json::serialize(Json::deserialize(twice, Json::SOURCE_KEEP), Json::FORMAT_MINIFIED));
+
+	/* The parallel serializer writes the same. */
+	Json::ThreadPool pool(2);
+	out.clear();
+	Json::serialize(msg, out, Json::FORMAT_MINIFIED, pool);
+	TEST_ASSERT(json, out);
+
+	TEST_THROWS(Json::deserialize("{\"a\":1,}", Json::SOURCE_KEEP), Json::Exception);
+	TEST_THROWS(Json::deserialize("[1] 2", Json::SOURCE_KEEP), Json::Exception);
+}
+
+void
+JsonStringSuite::raw()
+{
+	/* Written as it is; not parsed, so neither reordered nor respelled. */
+	std::string blob = "{\"z\":1.50,\"a\":[ 1, 2 ]}";
+	Json::RawJson cached(blob);
+	TEST_ASSERT(blob, std::string(cached.json()));
+
+	Json::Value data = Json::Builder::create(cached);
+	TEST_ASSERT(Json::JVRAW, data.getType());
+	TEST_ASSERT(blob, Json::serialize(data, Json::FORMAT_MINIFIED));
+	TEST_ASSERT(blob, Json::serialize(data, Json::FORMAT_PRETTY));
+	TEST_THROWS(data.asObject(), Json::Exception);
+	TEST_THROWS(Json::Builder::create(1).asRawJson(), Json::Exception);
+
+	Json::Value response = Json::Builder::create(Json::value_t(Json::Object()));
+	response.set("meta", Json::Builder::create(7));
+	response.set("data", data);
+	std::string out = Json::serialize(response, Json::FORMAT_MINIFIED);
+	TEST_ASSERT("{\"data\":" + blob + ",\"meta\":7}", out);
+	TEST_ASSERT(out.length(), Json::serializedSize(response, Json::FORMAT_MINIFIED));
+
+	out = Json::serialize(response, Json::FORMAT_PRETTY);
+	TEST_ASSERT("{\n\t\"data\" : " + blob + ",\n\t\"meta\" : 7\n}", out);
+	TEST_ASSERT(out.length(), Json::serializedSize(response, Json::FORMAT_PRETTY));
+
+	/* Copies share the fragment. */
+	Json::Value copy = response;
+	TEST_ASSERT(true, copy["data"].asRawJson().json().data() == data.asRawJson().json().data());
+
+	/* Through the typed serializers and the streaming writer. */
+	std::vector<Json::RawJson> list(2, Json::RawJson(std::string("[true]")));
+	TEST_ASSERT("[[true],[true]]", Json::serialize(list, Json::FORMAT_MINIFIED));
+
+	std::string written;
+	{
+		Json::Writer w([&written](const char *data, size_t length) { written.append(data, length); });
+		w.beginArray().value(cached).value(Json::Builder::create(cached)).endArray();
+	}
+	TEST_ASSERT("[" + blob + "," + blob + "]", written);
+}
@@ -25,6 +25,15 @@ class JsonStringSuite
 		void deepArray();
 		void deepObject();
 		void mixed();
+		void minified();
+		void appending();
+		void concurrent();
+		void containers();
+		void parallel();
+		void sizes();
+		void memoized();
+		void passthrough();
+		void raw();
 };
 
 #endif
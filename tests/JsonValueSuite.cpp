@@ -4,7 +4,9 @@
 #include <pjson/pjson.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <cmath>
 #include <string>
+#include <unordered_set>
 
 void
 JsonValueSuite::run()
@@ -32,6 +34,20 @@ JsonValueSuite::run()
 	this->invalidGet();
 	this->objectHasKey();
 	this->arrayHasKey();
+	this->find();
+	this->references();
+	this->copyOnWrite();
+	this->heldReferences();
+	this->sharingResumes();
+	this->mutableReads();
+	this->mutate();
+	this->iterate();
+	this->keys();
+	this->packed();
+	this->bigIntegers();
+	this->equality();
+	this->hashing();
+	this->canonical();
 }
 
 void JsonValueSuite::report()
@@ -49,6 +65,12 @@ JsonValueSuite::validString()
 	std::string json2 = readfile("data/validstring2.json");
 	Json::Value p2 = Json::deserialize(json2);
 	TEST_ASSERT("This is a valid \"json\" string", p2.asString());
+
+	/* Whitespace after an escaped quote is part of the string, and an escaped backslash escapes no quote. */
+	TEST_ASSERT("\" ", Json::deserialize("{\"k\":\"\\\" \"}")["k"].asString());
+	TEST_ASSERT("ends in \\", Json::deserialize("\"ends in \\\\\"").asString());
+	TEST_ASSERT("\\", Json::deserialize("[ \"\\\\\" , 1 ]")[0].asString());
+	TEST_ASSERT("{\"k\":\"\\\" \\\\\",\"l\":1}", Json::Value::minify("{ \"k\" : \"\\\" \\\\\", \"l\" : 1 }"));
 }
 
 void
@@ -405,3 +427,459 @@ JsonValueSuite::arrayHasKey()
 	Json::Value v2 = Json::deserialize(jsonstr);
 	TEST_ASSERT(false, v2.arrayHasKey(0));
 }
+
+void
+JsonValueSuite::find()
+{
+	std::string json1 = "{ \"a\" : { \"b\" : [10, 20] } }";
+	Json::Value v1 = Json::deserialize(json1);
+
+	const Json::Value *a = v1.find("a");
+	TEST_ASSERT(true, NULL != a);
+	TEST_ASSERT(true, NULL == v1.find("nokey"));
+	TEST_ASSERT(true, NULL == v1.find(0));
+
+	const Json::Value *b = a->find(std::string("b"));
+	TEST_ASSERT(true, NULL != b);
+	TEST_ASSERT(20, b->find(1)->asInt());
+	TEST_ASSERT(true, NULL == b->find(2));
+	TEST_ASSERT(true, NULL == b->find(-1));
+	TEST_ASSERT(true, NULL == b->find("b"));
+}
+
+void
+JsonValueSuite::references()
+{
+	std::string json1 = "{ \"a\" : { \"b\" : \"deep\" } }";
+	const Json::Value v1 = Json::deserialize(json1);
+
+	const Json::Value& a1 = v1["a"];
+	const Json::Value& a2 = v1["a"];
+	TEST_ASSERT(&a1, &a2);
+	TEST_ASSERT(&v1.asObject(), &v1.asObject());
+	TEST_ASSERT(&a1["b"].asString(), &a1["b"].asString());
+	TEST_ASSERT("deep", a1["b"].asStringView());
+	TEST_THROWS(v1.asStringView(), Json::Exception);
+}
+
+void
+JsonValueSuite::copyOnWrite()
+{
+	std::string json1 = "{ \"arr\" : [1, 2, 3], \"str\" : \"a string long enough to be shared\" }";
+	Json::Value v1 = Json::deserialize(json1);
+	Json::Value v2 = v1;
+
+	const Json::Value& c1 = v1;
+	const Json::Value& c2 = v2;
+	TEST_ASSERT(&c1.asObject(), &c2.asObject());
+	TEST_ASSERT(&c1["str"].asString(), &c2["str"].asString());
+
+	v2.asObject()["arr"].asArray()[0] = Json::Builder::create(42);
+	TEST_ASSERT(false, &c1.asObject() == &c2.asObject());
+	TEST_ASSERT(1,  c1["arr"][0].asInt());
+	TEST_ASSERT(42, c2["arr"][0].asInt());
+	TEST_ASSERT(&c1["str"].asString(), &c2["str"].asString());
+
+	Json::Value v3 = v2;
+	v2.asObject().erase("str");
+	TEST_ASSERT(false, v2.objectHasKey("str"));
+	TEST_ASSERT(true,  v3.objectHasKey("str"));
+	TEST_ASSERT(42,    v3["arr"][0].asInt());
+}
+
+void
+JsonValueSuite::heldReferences()
+{
+	std::string json = "{ \"a\" : { \"b\" : [1, \"a string long enough to be kept\", 3, 4, 5, 6, 7, 8] }, \"c\" : 1 }";
+	Json::Value v = Json::deserialize(json);
+
+	/* A reference kept across a copy does not reach into the copy. */
+	Json::Object& obj = v.asObject();
+	Json::Array& arr  = v.asObject()["a"].asObject()["b"].asArray();
+	Json::Value copy  = v;
+	obj["c"] = Json::Builder::create(2);
+	arr[0]   = Json::Builder::create(42);
+	TEST_ASSERT(1,  copy["c"].asInt());
+	TEST_ASSERT(1,  copy["a"]["b"][0].asInt());
+	TEST_ASSERT(2,  v["c"].asInt());
+	TEST_ASSERT(42, v["a"]["b"][0].asInt());
+
+	/* Nor does one kept across hashing or memoized serialization leave them stale. */
+	Json::Value& b = v.asObject()["a"].asObject()["b"];
+	Json::UInt64 h = v.hash();
+	std::string out;
+	Json::serializeMemoized(v, out, Json::FORMAT_MINIFIED);
+	b.push_back(Json::Builder::create(9));
+	TEST_ASSERT(true, h != v.hash());
+	TEST_ASSERT(true, v.hash() == Json::deserialize(Json::serialize(v, Json::FORMAT_MINIFIED)).hash());
+	out.clear();
+	Json::serializeMemoized(v, out, Json::FORMAT_MINIFIED);
+	TEST_ASSERT(Json::serialize(v, Json::FORMAT_MINIFIED), out);
+	TEST_ASSERT(true, std::string::npos != out.find(",9]"));
+
+	/* Copies are shared and kept for again. */
+	Json::Value frozen = v;
+	Json::Value again  = frozen;
+	const Json::Value& c1 = frozen;
+	const Json::Value& c2 = again;
+	TEST_ASSERT(&c1.asObject(), &c2.asObject());
+	TEST_ASSERT(v.hash(), again.hash());
+}
+
+void
+JsonValueSuite::sharingResumes()
+{
+	std::string json = "{ \"a\" : \"a string long enough for its Object to be kept\", \"b\" : [1, 2, 3], \"c\" : 1 }";
+	Json::Value v = Json::deserialize(json);
+
+	/* Modifying the Object through set() ends the borrow from asObject(). */
+	Json::Object& obj = v.asObject();
+	obj["c"] = Json::Builder::create(2);
+	Json::Value& d = v.set("d", Json::Builder::create(3));
+
+	Json::Value copy = v;
+	const Json::Value& c1 = v;
+	const Json::Value& c2 = copy;
+	TEST_ASSERT(&c1.asObject(), &c2.asObject());
+
+	/*
+	 * Writing through the reference set() returned, which is not to be
+	 * done once the value is copied, reveals what is kept and shared.
+	 */
+	std::string out;
+	Json::serializeMemoized(v, out, Json::FORMAT_MINIFIED);
+	Json::UInt64 h = v.hash();
+	std::string kept = out;
+	d = Json::Builder::create(4);
+	out.clear();
+	Json::serializeMemoized(copy, out, Json::FORMAT_MINIFIED);
+	TEST_ASSERT(kept, out);
+	TEST_ASSERT(h, copy.hash());
+	TEST_ASSERT(true, std::string::npos != kept.find("\"d\":3"));
+
+	/* The same holds for Arrays. */
+	Json::Array& arr = v["b"].asArray();
+	arr[0] = Json::Builder::create(42);
+	v["b"].erase(2);
+	Json::Value b = v["b"];
+	const Json::Value& b1 = c1["b"];
+	const Json::Value& b2 = b;
+	TEST_ASSERT(&b1.asArray(), &b2.asArray());
+	TEST_ASSERT(42, b[0].asInt());
+	TEST_ASSERT(2u, b.asArray().size());
+}
+
+void
+JsonValueSuite::mutableReads()
+{
+	Json::Value doc  = Json::deserialize("{ \"v\" : [1, 2, 3, 4, 5, 6], \"s\" : \"a string long enough for its Object to be kept\" }");
+	Json::Value copy = doc;
+	const Json::Value& c1 = doc;
+	const Json::Value& c2 = copy;
+
+	/* Looking up a member leaves it packed and shared. */
+	TEST_ASSERT(6u, doc["v"].asIntSpan().size());
+	TEST_ASSERT(c1["v"].asIntSpan().begin(), c2["v"].asIntSpan().begin());
+	TEST_ASSERT(std::string("a string long enough for its Object to be kept"), doc["s"].asString());
+
+	/* So is the Object it is in, once it is copied again. */
+	Json::Value again = doc;
+	const Json::Value& c3 = again;
+	TEST_ASSERT(&c1.asObject(), &c3.asObject());
+	TEST_ASSERT(copy.hash(), again.hash());
+	std::string out;
+	Json::serializeMemoized(again, out, Json::FORMAT_MINIFIED);
+	TEST_ASSERT(Json::serialize(copy, Json::FORMAT_MINIFIED), out);
+
+	/* Indexing the Array through a non-const Value unpacks it. */
+	TEST_ASSERT(6, doc["v"][5].asInt());
+	TEST_THROWS(doc["v"].asIntSpan(), Json::Exception);
+	TEST_ASSERT(6u, c2["v"].asIntSpan().size());
+	TEST_ASSERT(6, c2["v"][5].asInt());
+	TEST_ASSERT(true, doc == copy);
+}
+
+void
+JsonValueSuite::mutate()
+{
+	std::string json1 = "{ \"id\" : 7, \"tags\" : [\"a\", \"c\"] }";
+	Json::Value v1 = Json::deserialize(json1);
+	Json::Value orig = v1;
+
+	v1.set("source", Json::Builder::create(std::string("proxy")));
+	v1.set("id", Json::Builder::create(8));
+	v1["tags"].insert(1, Json::Builder::create(std::string("b")));
+	v1["tags"].push_back(Json::Builder::create(std::string("d")));
+	v1["tags"].erase(0);
+	v1["tags"][0] = Json::Builder::create(std::string("B"));
+
+	TEST_ASSERT("proxy", v1["source"].asString());
+	TEST_ASSERT(8,       v1["id"].asInt());
+	TEST_ASSERT(3,       (int)v1["tags"].asArray().size());
+	TEST_ASSERT("B",     v1["tags"][0].asString());
+	TEST_ASSERT("c",     v1["tags"][1].asString());
+	TEST_ASSERT("d",     v1["tags"][2].asString());
+	TEST_THROWS(v1["tags"].insert(4, Json::Builder::create()), Json::Exception);
+	TEST_THROWS(v1["tags"].erase(3), Json::Exception);
+	TEST_THROWS(v1["missing"], Json::Exception);
+
+	TEST_ASSERT(true,  v1.erase("source"));
+	TEST_ASSERT(false, v1.erase("source"));
+	TEST_THROWS(v1["id"].set("key", Json::Builder::create()), Json::Exception);
+
+	TEST_ASSERT(7,   orig["id"].asInt());
+	TEST_ASSERT(2,   (int)orig["tags"].asArray().size());
+	TEST_ASSERT("a", orig["tags"][0].asString());
+
+	Json::Value v2 = Json::Builder::create();
+	v2.set("list", Json::Builder::create()).push_back(Json::Builder::create(1));
+	TEST_ASSERT(Json::JVOBJECT, v2.getType());
+	TEST_ASSERT(Json::JVARRAY,  v2["list"].getType());
+	TEST_ASSERT(1,              v2["list"][0].asInt());
+}
+
+void
+JsonValueSuite::iterate()
+{
+	Json::Value v1 = Json::deserialize("[1, 2, 3, 4]");
+	int sum = 0;
+	for (const Json::Value& v : v1) sum += v.asInt();
+	TEST_ASSERT(10, sum);
+	TEST_ASSERT(4, (int)v1.elements().size());
+	const Json::Value& c1 = v1;
+	TEST_ASSERT(&c1.asArray()[0], &*c1.elements().begin());
+
+	Json::Value v2 = Json::deserialize("{ \"b\" : 2, \"a\" : 1 }");
+	std::string keys;
+	sum = 0;
+	for (const auto& item : v2.items()) {
+		keys += item.first;
+		sum  += item.second.asInt();
+	}
+	TEST_ASSERT("ab", keys);
+	TEST_ASSERT(3, sum);
+
+	Json::Value v3 = Json::deserialize("[]");
+	TEST_ASSERT(true, v3.elements().empty());
+	TEST_THROWS(v2.begin(), Json::Exception);
+	TEST_THROWS(v1.items(), Json::Exception);
+}
+
+void
+JsonValueSuite::keys()
+{
+	static const Json::Key kUser("user");
+	static const Json::Key kName("name");
+	static const Json::Key kMissing("missing");
+
+	Json::Value v1 = Json::deserialize("{ \"user\" : { \"name\" : \"Mat\" } }");
+	TEST_ASSERT("Mat", v1[kUser][kName].asString());
+	TEST_ASSERT(true, NULL == v1.find(kMissing));
+	TEST_ASSERT(&v1.find("user")->asObject(), &v1.find(kUser)->asObject());
+	TEST_THROWS(v1[kMissing], Json::Exception);
+
+	TEST_ASSERT(4, (int)kUser.length());
+	TEST_ASSERT(true, kUser == Json::Key(std::string("user")));
+	TEST_ASSERT(true, kUser != kName);
+}
+
+void
+JsonValueSuite::packed()
+{
+	Json::Value v1 = Json::deserialize("[1, -2, 3]");
+	const Json::Value& c1 = v1;
+	Json::IntSpan ints = c1.asIntSpan();
+	TEST_ASSERT(3,  (int)ints.size());
+	TEST_ASSERT(-2, (int)ints.begin()[1]);
+	TEST_THROWS(c1.asDoubleSpan(), Json::Exception);
+	TEST_ASSERT(3,  c1[2].asInt());
+	TEST_ASSERT(true, c1[2].isInteger());
+	TEST_ASSERT(ints.begin(), c1.asIntSpan().begin());
+
+	Json::Value v2 = Json::deserialize("[1, 2.5]");
+	Json::DoubleSpan doubles = v2.asDoubleSpan();
+	TEST_ASSERT(2,   (int)doubles.size());
+	TEST_ASSERT(1.0, doubles.begin()[0]);
+	TEST_ASSERT(2.5, doubles.begin()[1]);
+
+	TEST_THROWS(Json::deserialize("[1, \"2\"]").asIntSpan(), Json::Exception);
+	TEST_THROWS(Json::deserialize("[]").asIntSpan(), Json::Exception);
+
+	std::vector<double> series(1000, 0.5);
+	const double *data = series.data();
+	const Json::Value v3 = Json::Builder::create(std::move(series));
+	TEST_ASSERT(data, v3.asDoubleSpan().begin());
+	TEST_ASSERT(1000, (int)v3.asArray().size());
+	TEST_ASSERT(data, v3.asDoubleSpan().begin());
+
+	Json::Value v4 = v1;
+	v1.push_back(Json::Builder::create(4));
+	TEST_ASSERT(4, (int)v1.asArray().size());
+	TEST_ASSERT(4, v1[3].asInt());
+	TEST_THROWS(v1.asIntSpan(), Json::Exception);
+	TEST_ASSERT(3, (int)v4.asIntSpan().size());
+}
+
+void
+JsonValueSuite::bigIntegers()
+{
+	/* 2^53 + 1 is the first integer a double can not hold. */
+	Json::Value v1 = Json::deserialize("9007199254740993");
+	TEST_ASSERT(true, v1.isInteger());
+	TEST_ASSERT(Json::Int64(9007199254740993LL), v1.asInt64());
+	TEST_ASSERT(std::string("9007199254740993"), Json::serialize(v1, Json::FORMAT_MINIFIED));
+	TEST_THROWS(v1.asInt(), Json::Exception);
+
+	Json::Value v2 = Json::deserialize("18446744073709551615");
+	TEST_ASSERT(std::numeric_limits<Json::UInt64>::max(), v2.asUInt64());
+	TEST_THROWS(v2.asInt64(), Json::Exception);
+	TEST_ASSERT(std::string("18446744073709551615"), Json::serialize(v2, Json::FORMAT_MINIFIED));
+
+	Json::Value v3 = Json::deserialize("-9223372036854775808");
+	TEST_ASSERT(std::numeric_limits<Json::Int64>::min(), v3.asInt64());
+	TEST_THROWS(v3.asUInt64(), Json::Exception);
+
+	Json::Value v4 = Json::deserialize("18446744073709551616");
+	TEST_ASSERT(false, v4.isInteger());
+	TEST_ASSERT(18446744073709551616.0, v4.asNumber());
+
+	Json::Value v5 = Json::Builder::create(Json::Int64(5));
+	TEST_ASSERT(5, v5.asInt());
+	TEST_ASSERT(Json::UInt64(5), v5.asUInt64());
+
+	Json::Value v6 = Json::deserialize("[1, 9007199254740993]");
+	const Json::Value& c6 = v6;
+	TEST_ASSERT(Json::Int64(9007199254740993LL), c6.asIntSpan().begin()[1]);
+	TEST_ASSERT(Json::Int64(9007199254740993LL), c6[1].asInt64());
+
+	Json::Value v7 = Json::deserialize("[1, 18446744073709551615]");
+	TEST_THROWS(v7.asIntSpan(), Json::Exception);
+	TEST_ASSERT(std::numeric_limits<Json::UInt64>::max(), v7[1].asUInt64());
+
+	/* Doubles convert only if they are integers in range. */
+	TEST_ASSERT(Json::Int64(-4), Json::deserialize("-4.0").asInt64());
+	TEST_ASSERT(Json::UInt64(1) << 63, Json::deserialize("9223372036854775808.0").asUInt64());
+	TEST_THROWS(Json::deserialize("2.5").asInt64(), Json::Exception);
+	TEST_ASSERT(-4, Json::deserialize("-4.0").asInt());
+	TEST_ASSERT(2147483647, Json::deserialize("2147483647.0").asInt());
+	TEST_THROWS(Json::deserialize("3e9").asInt(), Json::Exception);
+	TEST_THROWS(Json::deserialize("1.5").asInt(), Json::Exception);
+	TEST_THROWS(Json::deserialize("2.5").asUInt64(), Json::Exception);
+	TEST_THROWS(Json::deserialize("1e30").asInt64(), Json::Exception);
+	TEST_THROWS(Json::deserialize("1e30").asUInt64(), Json::Exception);
+	TEST_THROWS(Json::deserialize("9223372036854775808.0").asInt64(), Json::Exception);
+	TEST_THROWS(Json::deserialize("-1.0").asUInt64(), Json::Exception);
+	TEST_THROWS(Json::Builder::create(std::numeric_limits<double>::quiet_NaN()).asInt64(), Json::Exception);
+
+	/* -0 keeps its sign. */
+	Json::Value v8 = Json::deserialize("-0");
+	TEST_ASSERT(false, v8.isInteger());
+	TEST_ASSERT(true, std::signbit(v8.asNumber()));
+	TEST_ASSERT(true, std::signbit(Json::deserializeInto<double>("-0")));
+	TEST_ASSERT(std::string("-0"), Json::serialize(v8, Json::FORMAT_MINIFIED));
+}
+
+void
+JsonValueSuite::equality()
+{
+	std::string json = "{ \"a\" : [1, 2.5, \"x\"], \"b\" : { \"c\" : null, \"d\" : true }, \"e\" : 18446744073709551615 }";
+	Json::Value v = Json::deserialize(json);
+
+	TEST_ASSERT(true, v == Json::deserialize(json));
+	TEST_ASSERT(true, v == Json::deserialize(json, Json::SOURCE_KEEP));
+	TEST_ASSERT(true, v == v);
+	TEST_ASSERT(false, v != Json::Value(v));
+
+	Json::Value w = v;
+	w["b"].set("d", Json::Builder::create(false));
+	TEST_ASSERT(true, v != w);
+	w["b"].set("d", Json::Builder::create(true));
+	TEST_ASSERT(true, v == w);
+	w.erase("e");
+	TEST_ASSERT(true, v != w);
+
+	/* Numbers are equal by value, however they are stored. */
+	TEST_ASSERT(true, Json::Builder::create(1) == Json::Builder::create(1.0));
+	TEST_ASSERT(true, Json::Builder::create(0) == Json::Builder::create(-0.0));
+	TEST_ASSERT(true, Json::Builder::create(Json::UInt64(1) << 63) == Json::Builder::create(9223372036854775808.0));
+	TEST_ASSERT(false, Json::Builder::create(1) == Json::Builder::create(1.5));
+	TEST_ASSERT(false, Json::Builder::create(1) == Json::Builder::create(true));
+	TEST_ASSERT(false, Json::Builder::create(Json::Int64(-1)) == Json::Builder::create(Json::UInt64(-1)));
+	TEST_ASSERT(false, Json::Builder::create() == Json::Builder::create(0));
+	TEST_ASSERT(false, Json::Builder::create("") == Json::Builder::create(Json::value_t(Json::Array())));
+
+	/* Packed Arrays equal Arrays of the same numbers. */
+	Json::Array numbers;
+	numbers.push_back(Json::Builder::create(1));
+	numbers.push_back(Json::Builder::create(2));
+	numbers.push_back(Json::Builder::create("3"));
+	Json::Value mixed = Json::Builder::create(Json::value_t(numbers));
+	TEST_ASSERT(false, Json::deserialize("[1, 2, 3]") == mixed);
+	mixed[2] = Json::Builder::create(3.0);
+	TEST_ASSERT(true, Json::deserialize("[1, 2, 3]") == mixed);
+	TEST_ASSERT(true, Json::deserialize("[1, 2, 3.0]") == Json::deserialize("[1.0, 2, 3]"));
+	TEST_ASSERT(false, Json::deserialize("[1, 2, 3]") == Json::deserialize("[1, 2]"));
+
+	/* Raw fragments are compared by what they hold. */
+	Json::Value raw = Json::Builder::create(Json::RawJson(std::string("{\"b\":{\"d\":true,\"c\":null},\"e\":18446744073709551615,\"a\":[1,2.50,\"x\"]}")));
+	TEST_ASSERT(true, raw == v);
+	TEST_ASSERT(true, v == raw);
+	TEST_ASSERT(false, raw == w);
+}
+
+void
+JsonValueSuite::hashing()
+{
+	std::string json = "{ \"a\" : [1, 2.5, \"x\"], \"b\" : { \"c\" : null, \"d\" : true }, \"long key of some length\" : \"and a value\" }";
+	Json::Value v = Json::deserialize(json);
+
+	/* Stable: the same in every process. */
+	Json::UInt64 h = v.hash();
+	TEST_ASSERT(true, h == Json::deserialize(json).hash());
+	TEST_ASSERT(true, h == Json::deserialize(json, Json::SOURCE_KEEP).hash());
+	TEST_ASSERT(true, h == v.hash());
+	TEST_ASSERT(true, Json::Builder::create(Json::RawJson(Json::serializeCanonical(v))).hash() == h);
+
+	/* What was kept is dropped along the path to a modification. */
+	Json::Value w = v;
+	w["b"].set("c", Json::Builder::create(0));
+	TEST_ASSERT(true, w.hash() != h);
+	TEST_ASSERT(true, v.hash() == h);
+	w["b"].set("c", Json::Builder::create());
+	TEST_ASSERT(true, w.hash() == h);
+
+	TEST_ASSERT(true, Json::Builder::create(1).hash() == Json::Builder::create(1.0).hash());
+	TEST_ASSERT(true, Json::deserialize("[1, 2, 3]").hash() == Json::deserialize("[1.0, 2, 3]").hash());
+	TEST_ASSERT(true, Json::deserialize("[1, 2]").hash() != Json::deserialize("[2, 1]").hash());
+	TEST_ASSERT(true, Json::deserialize("{\"a\" : 1}").hash() != Json::deserialize("{\"1\" : \"a\"}").hash());
+	TEST_ASSERT(true, Json::Builder::create("").hash() != Json::deserialize("[]").hash());
+	TEST_ASSERT(true, Json::Builder::create().hash() != Json::Builder::create(false).hash());
+
+	std::unordered_set<Json::Value> seen;
+	seen.insert(v);
+	seen.insert(Json::deserialize(json));
+	seen.insert(w);
+	seen.insert(Json::deserialize("[1, 2, 3]"));
+	seen.insert(Json::deserialize("[1.0, 2, 3]"));
+	TEST_ASSERT(2u, seen.size());
+}
+
+void
+JsonValueSuite::canonical()
+{
+	Json::Value v = Json::deserialize("{ \"z\" : [1.0, 2.50, -0.0, 1e2, 1.5e300], \"a\" : \"\\u00e9\\/\" }");
+	TEST_ASSERT("{\"a\":\"\xc3\xa9/\",\"z\":[1,2.5,0,100,1.5e+300]}", Json::serializeCanonical(v));
+
+	/* Whatever the number is stored as. */
+	TEST_ASSERT("9223372036854775808", Json::serializeCanonical(Json::Builder::create(9223372036854775808.0)));
+	TEST_ASSERT("9223372036854775808", Json::serializeCanonical(Json::Builder::create(Json::UInt64(1) << 63)));
+
+	/* Neither the source nor raw fragments are written as they are. */
+	std::string json = "{\"route\":{\"to\":\"somewhere far away\",\"hops\":3.0,\"via\":[\"a\",\"b\",\"c\"]},\"id\":1}";
+	Json::Value kept = Json::deserialize(json, Json::SOURCE_KEEP);
+	TEST_ASSERT(json, Json::serialize(kept, Json::FORMAT_MINIFIED));
+	std::string canonical = Json::serializeCanonical(kept);
+	TEST_ASSERT("{\"id\":1,\"route\":{\"hops\":3,\"to\":\"somewhere far away\",\"via\":[\"a\",\"b\",\"c\"]}}", canonical);
+	TEST_ASSERT(canonical, Json::serializeCanonical(Json::Builder::create(Json::RawJson(json))));
+	TEST_ASSERT(canonical, Json::serializeCanonical(Json::deserialize(canonical)));
+}
@@ -36,6 +36,20 @@ class JsonValueSuite
 		void invalidGet();
 		void objectHasKey();
 		void arrayHasKey();
+		void find();
+		void references();
+		void copyOnWrite();
+		void heldReferences();
+		void sharingResumes();
+		void mutableReads();
+		void mutate();
+		void iterate();
+		void keys();
+		void packed();
+		void bigIntegers();
+		void equality();
+		void hashing();
+		void canonical();
 };
 
 #endif
@@ -0,0 +1,133 @@
+#include "pjtestframework.hpp"
+#include "JsonWriterSuite.hpp"
+
+#include <sstream>
+#include <unistd.h>
+
+static void
+writeShows(Json::Writer& w)
+{
+	const char *names[]  = { "The walking dead", "How I met your mother", "Futurama" };
+	const int   ratings[] = { 5, 7, 10 };
+	const bool  zombies[] = { true, false, true };
+
+	w.beginArray();
+	for (int i = 0; i < 3; ++i) {
+		w.beginObject();
+		w.key("name").value(names[i]);
+		w.key("rating").value(ratings[i]);
+		w.key("zombies").value(zombies[i]);
+		w.endObject();
+	}
+	w.endArray();
+}
+
+void
+JsonWriterSuite::run()
+{
+	std::cout << "Running suite 'JsonWriter'.";
+
+	this->writeStream();
+	this->writePretty();
+	this->writeSink();
+	this->writeFd();
+	this->invalidWrite();
+}
+
+void
+JsonWriterSuite::report()
+{
+	std::cout << pjreport();
+}
+
+void
+JsonWriterSuite::writeStream()
+{
+	std::ostringstream os;
+	Json::Writer w(os);
+	w.beginObject();
+	w.key("a").value(Json::Int64(1) << 40);
+	w.key("b").beginArray().value(1.5).null().value(std::string("x\"y")).endArray();
+	w.key("c").value(Json::deserialize("{ \"d\" : [true] }"));
+	w.key("e").beginObject().endObject();
+	w.endObject();
+	TEST_ASSERT(true, w.complete());
+
+	w.flush();
+	TEST_ASSERT("{\"a\":1099511627776,\"b\":[1.5,null,\"x\\\"y\"],\"c\":{\"d\":[true]},\"e\":{}}", os.str());
+}
+
+void
+JsonWriterSuite::writePretty()
+{
+	std::ostringstream os;
+	{
+		Json::Writer w(os, Json::FORMAT_PRETTY);
+		writeShows(w);
+	}
+	TEST_ASSERT(readfile("data/strjson/mixed1.json"), os.str());
+}
+
+void
+JsonWriterSuite::writeSink()
+{
+	std::vector<std::string> chunks;
+	std::string expected;
+	{
+		Json::Writer w([&chunks](const char *data, size_t length) {
+			chunks.push_back(std::string(data, length));
+		}, Json::FORMAT_MINIFIED, 16);
+
+		w.beginArray();
+		for (int i = 0; i < 100; ++i) w.value(i);
+		w.endArray();
+	}
+
+	std::string joined;
+	for (const std::string& chunk : chunks) {
+		TEST_ASSERT(true, chunk.size() < 16 + 4);
+		joined += chunk;
+	}
+	TEST_ASSERT(true, chunks.size() > 10);
+	TEST_ASSERT(Json::serialize(Json::deserialize(joined), Json::FORMAT_MINIFIED), joined);
+	TEST_ASSERT(100, (int)Json::deserialize(joined).asArray().size());
+}
+
+void
+JsonWriterSuite::writeFd()
+{
+	int fds[2];
+	TEST_ASSERT(0, pipe(fds));
+
+	{
+		Json::Writer w(fds[1]);
+		w.beginObject().key("fd").value(true).endObject();
+	}
+	close(fds[1]);
+
+	char buf[64];
+	ssize_t n = read(fds[0], buf, sizeof(buf));
+	close(fds[0]);
+	TEST_ASSERT(std::string("{\"fd\":true}"), std::string(buf, n > 0 ? n : 0));
+}
+
+void
+JsonWriterSuite::invalidWrite()
+{
+	std::ostringstream os;
+
+	Json::Writer w1(os);
+	w1.beginObject();
+	TEST_THROWS(w1.value(1), Json::Exception);
+	TEST_THROWS(w1.endArray(), Json::Exception);
+	w1.key("k");
+	TEST_THROWS(w1.key("k"), Json::Exception);
+	TEST_THROWS(w1.endObject(), Json::Exception);
+
+	Json::Writer w2(os);
+	w2.beginArray();
+	TEST_THROWS(w2.key("k"), Json::Exception);
+	w2.endArray();
+	TEST_THROWS(w2.value(1), Json::Exception);
+	TEST_THROWS(w2.endArray(), Json::Exception);
+}
@@ -0,0 +1,25 @@
+#ifndef __JSONWRITERSUITE_HPP__
+#define __JSONWRITERSUITE_HPP__
+
+#include <pjson/pjson.hpp>
+#include <vector>
+#include <string>
+#include <iostream>
+
+class JsonWriterSuite
+{
+	public:
+		JsonWriterSuite() {};
+
+		void run();
+		void report();
+
+	private:
+		void writeStream();
+		void writePretty();
+		void writeSink();
+		void writeFd();
+		void invalidWrite();
+};
+
+#endif
@@ -8,6 +8,11 @@ PjsonSuite::run()
 
 	this->testSerialize();
 	this->testDeserialize();
+	this->testColumns();
+	this->testPatch();
+	this->testDiff();
+	this->testMergePatch();
+	this->testCbor();
 }
 
 void
@@ -44,3 +49,208 @@ PjsonSuite::testDeserialize()
 	TEST_ASSERT("Queen of Andor", wot[1]["title"].asString());
 	TEST_ASSERT(false,            wot[1]["ta'veren"].asBool());
 }
+
+void
+PjsonSuite::testColumns()
+{
+	std::string json = "["
+		"{ \"ts\" : 1, \"price\" : 9, \"sym\" : \"AB\" },"
+		"{ \"ts\" : 2, \"price\" : 9.5, \"sym\" : null, \"live\" : true },"
+		"{ \"ts\" : 3, \"sym\" : \"CDE\", \"live\" : false }"
+		"]";
+	Json::Value trades = Json::deserialize(json);
+
+	std::vector<std::string> keys;
+	keys.push_back("ts");
+	keys.push_back("price");
+	keys.push_back("sym");
+	keys.push_back("live");
+	keys.push_back("none");
+	Json::Columns cols = Json::toColumns(trades, keys);
+
+	TEST_ASSERT(3, (int)cols.rows);
+
+	const Json::Column& ts = cols["ts"];
+	TEST_ASSERT(Json::Column::COLUMN_INT, ts.type);
+	TEST_ASSERT(3, (int)ts.ints.size());
+	TEST_ASSERT(3, (int)ts.ints[2]);
+
+	const Json::Column& price = cols["price"];
+	TEST_ASSERT(Json::Column::COLUMN_DOUBLE, price.type);
+	TEST_ASSERT(9.0, price.doubles[0]);
+	TEST_ASSERT(9.5, price.doubles[1]);
+	TEST_ASSERT(true, price.isNull(2));
+	TEST_ASSERT(false, price.isNull(1));
+
+	const Json::Column& sym = cols["sym"];
+	TEST_ASSERT(Json::Column::COLUMN_STRING, sym.type);
+	TEST_ASSERT("AB",  sym.string(0));
+	TEST_ASSERT(true,  sym.isNull(1));
+	TEST_ASSERT("",    sym.string(1));
+	TEST_ASSERT("CDE", sym.string(2));
+
+	const Json::Column& live = cols["live"];
+	TEST_ASSERT(Json::Column::COLUMN_BOOL, live.type);
+	TEST_ASSERT(true,  live.isNull(0));
+	TEST_ASSERT(1, (int)live.bools[1]);
+	TEST_ASSERT(0, (int)live.bools[2]);
+	TEST_ASSERT(3, (int)live.bools.size());
+
+	TEST_ASSERT(Json::Column::COLUMN_NULL, cols["none"].type);
+	TEST_THROWS(cols["other"], Json::Exception);
+
+	Json::Value mixed = Json::deserialize("[{ \"a\" : 1 }, { \"a\" : \"1\" }]");
+	TEST_THROWS(Json::toColumns(mixed, std::vector<std::string>(1, "a")), Json::Exception);
+	TEST_THROWS(Json::toColumns(Json::deserialize("[1]"), keys), Json::Exception);
+}
+
+void
+PjsonSuite::testPatch()
+{
+	Json::Value doc = Json::deserialize("{ \"a/b\" : 1, \"m~n\" : [1, 2, 3], \"o\" : { \"p\" : true } }");
+	Json::Value orig = doc;
+
+	Json::applyPatch(doc, Json::deserialize("["
+		"{ \"op\" : \"test\", \"path\" : \"/a~1b\", \"value\" : 1.0 },"
+		"{ \"op\" : \"add\", \"path\" : \"/m~0n/1\", \"value\" : \"x\" },"
+		"{ \"op\" : \"add\", \"path\" : \"/m~0n/-\", \"value\" : 4 },"
+		"{ \"op\" : \"remove\", \"path\" : \"/m~0n/0\" },"
+		"{ \"op\" : \"replace\", \"path\" : \"/o/p\", \"value\" : false },"
+		"{ \"op\" : \"copy\", \"from\" : \"/o\", \"path\" : \"/c\" },"
+		"{ \"op\" : \"move\", \"from\" : \"/a~1b\", \"path\" : \"/c/q\" }"
+	"]"));
+	TEST_ASSERT("{\"c\":{\"p\":false,\"q\":1},\"m~n\":[\"x\",2,3,4],\"o\":{\"p\":false}}", Json::serialize(doc, Json::FORMAT_MINIFIED));
+
+	/* The original shares nothing which was modified. */
+	TEST_ASSERT("{\"a/b\":1,\"m~n\":[1,2,3],\"o\":{\"p\":true}}", Json::serialize(orig, Json::FORMAT_MINIFIED));
+
+	/* Copies of the patched value share it. */
+	Json::Value shared = doc;
+	const Json::Value& c1 = doc;
+	const Json::Value& c2 = shared;
+	TEST_ASSERT(&c1.asObject(), &c2.asObject());
+
+	/* The whole document may be replaced. */
+	Json::Value root = Json::deserialize("[1]");
+	Json::applyPatch(root, Json::deserialize("[{ \"op\" : \"replace\", \"path\" : \"\", \"value\" : \"all\" }]"));
+	TEST_ASSERT("all", root.asString());
+
+	/* A failing operation leaves the value as it was. */
+	Json::Value kept = doc;
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"remove\", \"path\" : \"/o\" }, { \"op\" : \"test\", \"path\" : \"/c/q\", \"value\" : 2 }]")), Json::Exception);
+	TEST_ASSERT(true, kept == doc);
+
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"remove\", \"path\" : \"/nothing\" }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"add\", \"path\" : \"/m~0n/5\", \"value\" : 1 }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"add\", \"path\" : \"/m~0n/01\", \"value\" : 1 }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"remove\", \"path\" : \"/m~0n/-\" }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"add\", \"path\" : \"/x~2\", \"value\" : 1 }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"add\", \"path\" : \"x\", \"value\" : 1 }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"add\", \"path\" : \"/x\" }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"move\", \"from\" : \"/c\", \"path\" : \"/c/r\" }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("[{ \"op\" : \"swap\", \"path\" : \"/c\" }]")), Json::Exception);
+	TEST_THROWS(Json::applyPatch(doc, Json::deserialize("{ \"op\" : \"remove\", \"path\" : \"/c\" }")), Json::Exception);
+	TEST_ASSERT(true, kept == doc);
+}
+
+void
+PjsonSuite::testDiff()
+{
+	const char *pairs[][2] = {
+		{ "{ \"a\" : 1, \"b\" : [1, 2, 3, 4], \"c/~\" : { \"d\" : null } }",
+		  "{ \"b\" : [1, 5, 6, 7, 4], \"c/~\" : { \"d\" : 0, \"e\" : [] }, \"f\" : \"g\" }" },
+		{ "[1, 2, 3, 4, 5]", "[1, 5]" },
+		{ "[[1, 2], { \"a\" : 1 }]", "[[1, 3], { \"a\" : 2 }, 3]" },
+		{ "{ \"a\" : 1 }", "[1]" },
+		{ "[]", "[1, 2]" },
+	};
+
+	for (auto& pair : pairs) {
+		Json::Value from = Json::deserialize(pair[0]), to = Json::deserialize(pair[1]);
+		Json::Value patched = from;
+		Json::applyPatch(patched, Json::diff(from, to));
+		TEST_ASSERT(Json::serialize(to, Json::FORMAT_MINIFIED), Json::serialize(patched, Json::FORMAT_MINIFIED));
+	}
+
+	Json::Value from = Json::deserialize("{ \"big\" : [1, 2, 3], \"n\" : 1.0, \"s\" : { \"x\" : 1 } }");
+	Json::Value to = from;
+	to["s"].set("x", Json::Builder::create(2));
+	TEST_ASSERT("[{\"op\":\"replace\",\"path\":\"/s/x\",\"value\":2}]", Json::serialize(Json::diff(from, to), Json::FORMAT_MINIFIED));
+	TEST_ASSERT(0u, Json::diff(from, Json::deserialize("{ \"big\" : [1, 2, 3], \"n\" : 1, \"s\" : { \"x\" : 1 } }")).asArray().size());
+	TEST_ASSERT("[{\"op\":\"remove\",\"path\":\"/1\"},{\"op\":\"remove\",\"path\":\"/1\"}]",
+	            Json::serialize(Json::diff(Json::deserialize("[1, 2, 3, 4]"), Json::deserialize("[1, 4]")), Json::FORMAT_MINIFIED));
+}
+
+void
+PjsonSuite::testMergePatch()
+{
+	Json::Value v = Json::deserialize("{ \"a\" : \"b\", \"c\" : { \"d\" : \"e\", \"f\" : \"g\" }, \"h\" : [1] }");
+	Json::mergePatch(v, Json::deserialize("{ \"a\" : \"z\", \"c\" : { \"f\" : null }, \"h\" : { \"i\" : { \"j\" : null, \"k\" : 1 } }, \"x\" : null }"));
+	TEST_ASSERT("{\"a\":\"z\",\"c\":{\"d\":\"e\"},\"h\":{\"i\":{\"k\":1}}}", Json::serialize(v, Json::FORMAT_MINIFIED));
+
+	Json::mergePatch(v, Json::deserialize("[1, 2]"));
+	TEST_ASSERT("[1,2]", Json::serialize(v, Json::FORMAT_MINIFIED));
+
+	Json::mergePatch(v, Json::deserialize("{ \"a\" : null }"));
+	TEST_ASSERT("{}", Json::serialize(v, Json::FORMAT_MINIFIED));
+}
+
+void
+PjsonSuite::testCbor()
+{
+	/* Examples from RFC 8949, appendix A. */
+	TEST_ASSERT(std::string("\x00", 1), Json::toCBOR(Json::Builder::create(0)));
+	TEST_ASSERT("\x17", Json::toCBOR(Json::Builder::create(23)));
+	TEST_ASSERT("\x18\x64", Json::toCBOR(Json::Builder::create(100)));
+	TEST_ASSERT("\x1b\xff\xff\xff\xff\xff\xff\xff\xff", Json::toCBOR(Json::Builder::create(std::numeric_limits<Json::UInt64>::max())));
+	TEST_ASSERT("\x39\x03\xe7", Json::toCBOR(Json::Builder::create(-1000)));
+	TEST_ASSERT(std::string("\xf9\x3e\x00", 3), Json::toCBOR(Json::Builder::create(1.5)));
+	TEST_ASSERT(std::string("\xf9\x80\x00", 3), Json::toCBOR(Json::Builder::create(-0.0)));
+	TEST_ASSERT(std::string("\xf9\x00\x01", 3), Json::toCBOR(Json::Builder::create(5.960464477539063e-8)));
+	TEST_ASSERT(std::string("\xfa\x47\xc3\x50\x00", 5), Json::toCBOR(Json::Builder::create(100000.0)));
+	TEST_ASSERT("\xfb\x3f\xf1\x99\x99\x99\x99\x99\x9a", Json::toCBOR(Json::Builder::create(1.1)));
+	TEST_ASSERT("\xf6", Json::toCBOR(Json::Builder::create()));
+	TEST_ASSERT("\xf5", Json::toCBOR(Json::Builder::create(true)));
+	TEST_ASSERT("\x64\x49\x45\x54\x46", Json::toCBOR(Json::Builder::create("IETF")));
+	TEST_ASSERT("\x83\x01\x82\x02\x03\x82\x04\x05", Json::toCBOR(Json::deserialize("[1, [2, 3], [4, 5]]")));
+	TEST_ASSERT("\xa2\x61\x61\x01\x61\x62\x82\x02\x03", Json::toCBOR(Json::deserialize("{ \"a\" : 1, \"b\" : [2, 3] }")));
+	TEST_ASSERT(std::string("\x82\xf9\x3e\x00\xf9\x3c\x00", 7), Json::toCBOR(Json::deserialize("[1.5, 1.0]")));
+
+	std::string json = "{\"a\":[1,-2,3.25,\"\\u00e9\\n\",true,false,null],\"b\":{\"c\":[],\"d\":{}},"
+	                   "\"e\":[18446744073709551615,-9223372036854775808,1e300]}";
+	Json::Value v = Json::deserialize(json);
+	std::string cbor = Json::toCBOR(v);
+	Json::Value back = Json::fromCBOR(cbor);
+	TEST_ASSERT(true, v == back);
+	TEST_ASSERT(Json::serialize(v, Json::FORMAT_MINIFIED), Json::serialize(back, Json::FORMAT_MINIFIED));
+	TEST_ASSERT(true, back["a"][1].isInteger());
+	TEST_ASSERT(-2, back["a"][1].asInt());
+	TEST_ASSERT(std::numeric_limits<Json::UInt64>::max(), back["e"][0].asUInt64());
+	TEST_ASSERT(std::numeric_limits<Json::Int64>::min(), back["e"][1].asInt64());
+
+	/* Raw fragments are written as what they hold. */
+	TEST_ASSERT(cbor, Json::toCBOR(Json::Builder::create(Json::RawJson(json))));
+
+	/* Arrays of numbers decode packed. */
+	TEST_ASSERT(3u, Json::fromCBOR(Json::toCBOR(Json::deserialize("[1, 2, 3]"))).asIntSpan().size());
+	TEST_ASSERT(2u, Json::fromCBOR(Json::toCBOR(Json::deserialize("[1.5, 2]"))).asDoubleSpan().size());
+
+	/* Indefinite lengths, tags, byte strings and undefined. */
+	TEST_ASSERT("{\"a\":[1,\"strea\",\"ming\"],\"b\":null}",
+	            Json::serialize(Json::fromCBOR("\xbf\x61\x61\x9f\x01\x7f\x65strea\xff\xc0\x64ming\xff\x61\x62\xf7\xff"), Json::FORMAT_MINIFIED));
+	TEST_ASSERT("AQID_w", Json::fromCBOR("\x44\x01\x02\x03\xff").asString());
+	TEST_ASSERT(-18446744073709551616.0, Json::fromCBOR("\x3b\xff\xff\xff\xff\xff\xff\xff\xff").asNumber());
+	TEST_ASSERT(65504.0, Json::fromCBOR("\xf9\x7b\xff").asNumber());
+
+	TEST_THROWS(Json::fromCBOR(""), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\x83\x01\x02"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\x9b\x00\x00\x00\x01\x00\x00\x00\x00"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\x64IET"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\xa1\x01\x02"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\xbf\x61\x61\xff"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\x01\x02"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\xff"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\xe0"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\x1c"), Json::Exception);
+	TEST_THROWS(Json::fromCBOR("\x7f\x41\x61\xff"), Json::Exception);
+}
@@ -17,6 +17,11 @@ class PjsonSuite
 	private:
 		void testSerialize();
 		void testDeserialize();
+		void testColumns();
+		void testPatch();
+		void testDiff();
+		void testMergePatch();
+		void testCbor();
 };
 
 #endif
@@ -2,6 +2,9 @@
 #include "JsonBuilderSuite.hpp"
 #include "JsonStringSuite.hpp"
 #include "PjsonSuite.hpp"
+#include "JsonWriterSuite.hpp"
+#include "JsonReaderSuite.hpp"
+#include "JsonCodegenSuite.hpp"
 
 #include <iostream>
 
@@ -28,6 +31,21 @@ int main(void)
 		pjsonsuite->report();
 		delete pjsonsuite;
 
+		JsonWriterSuite *writersuite = new JsonWriterSuite();
+		writersuite->run();
+		writersuite->report();
+		delete writersuite;
+
+		JsonReaderSuite *readersuite = new JsonReaderSuite();
+		readersuite->run();
+		readersuite->report();
+		delete readersuite;
+
+		JsonCodegenSuite *codegensuite = new JsonCodegenSuite();
+		codegensuite->run();
+		codegensuite->report();
+		delete codegensuite;
+
 	} catch (Json::Exception e) {
 		std::cout << "Uncaught JSON exception: " << e.what() << std::endl;
 	} catch (...) {